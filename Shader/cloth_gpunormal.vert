@@ -0,0 +1,43 @@
+#version 330 core
+// Positions-only variant of cloth.vert: the normal is rebuilt from the faces around the vertex
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in vec3 aPrevPos; // Position at the previous physics tick
+
+out vec3 FragPos;
+out vec3 Normal;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform float alpha; // Blend towards aPos; 1 when not interpolating
+
+uniform samplerBuffer positions;         // Same buffer as aPos, one float per texel
+uniform isamplerBuffer adjacencyOffsets; // First adjacency entry of each vertex (vertexCount + 1 entries)
+uniform isamplerBuffer adjacency;        // The other two corners of each incident triangle, in winding order
+
+vec3 FetchPosition(int i) {
+    return vec3(texelFetch(positions, 3 * i).r,
+                texelFetch(positions, 3 * i + 1).r,
+                texelFetch(positions, 3 * i + 2).r);
+}
+
+void main() {
+    // In glDrawElements gl_VertexID is the element index, i.e. the particle index
+    int first = texelFetch(adjacencyOffsets, gl_VertexID).r;
+    int last  = texelFetch(adjacencyOffsets, gl_VertexID + 1).r;
+
+    // Area-weighted sum of the face normals, like the CPU path
+    vec3 n = vec3(0.0);
+    for (int k = first; k < last; k += 2) {
+        vec3 b = FetchPosition(texelFetch(adjacency, k).r);
+        vec3 c = FetchPosition(texelFetch(adjacency, k + 1).r);
+        n += cross(b - aPos, c - aPos);
+    }
+    if (dot(n, n) == 0.0) n = vec3(0.0, 1.0, 0.0); // Fallback
+
+    // The normal comes from the latest tick, only the position is blended
+    vec3 position = alpha < 1.0 ? mix(aPrevPos, aPos, alpha) : aPos;
+    FragPos = vec3(model * vec4(position, 1.0));
+    Normal = mat3(transpose(inverse(model))) * n;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
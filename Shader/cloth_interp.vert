@@ -0,0 +1,21 @@
+#version 330 core
+// cloth.vert that blends the last two fixed physics ticks
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec3 aPrevPos; // Position at the previous tick
+
+out vec3 FragPos;
+out vec3 Normal;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform float alpha; // Accumulator remainder / tick length, in [0, 1)
+
+void main() {
+    vec3 position = mix(aPrevPos, aPos, alpha);
+    FragPos = vec3(model * vec4(position, 1.0));
+    // Inverse transpose ensures normals stay accurate even if the model is rotated/scaled
+    Normal = mat3(transpose(inverse(model))) * aNormal;  
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
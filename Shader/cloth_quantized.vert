@@ -0,0 +1,33 @@
+#version 330 core
+// cloth.vert for the packed 8-byte vertices (see VertexPacking.h)
+layout (location = 0) in vec3 aPos;     // unorm16, [0, 1] inside the bounding box
+layout (location = 1) in vec2 aNormal;  // snorm8 octahedral coordinates
+layout (location = 2) in vec3 aPrevPos; // Position at the previous physics tick (full precision)
+
+out vec3 FragPos;
+out vec3 Normal;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform float alpha; // Blend towards the current position; 1 when not interpolating
+
+uniform vec3 boundsMin;
+uniform vec3 boundsExtent;
+
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0); // Unfold the lower half
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    vec3 current = boundsMin + aPos * boundsExtent;
+    vec3 position = alpha < 1.0 ? mix(aPrevPos, current, alpha) : current;
+    FragPos = vec3(model * vec4(position, 1.0));
+    // Inverse transpose ensures normals stay accurate even if the model is rotated/scaled
+    Normal = mat3(transpose(inverse(model))) * DecodeOctahedral(aNormal);
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
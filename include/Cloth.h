@@ -5,23 +5,76 @@
 #include "Particle.h"
 #include "SpringDamper.h"
 #include "Triangle.h"
+#include "Collider.h"
+#include "WindField.h"
+#include "VertexPacking.h"
+#include "ProjectiveDynamics.h"
+#include "SimDiagnostics.h"
 
 class Cloth {
 public:
     std::vector<Particle*> particles;
-    std::vector<SpringDamper*> springs;
-    std::vector<Triangle*> triangles;
+
+    // The grid's springs are not stored: each family is a set of directions (dx, dy) and
+    // the pairs (x, y) - (x + dx, y + dy) inside the grid are its springs.
+    SpringFamily structural; // (1, 0), (0, 1)
+    SpringFamily shear;      // (1, 1), (-1, 1)
+    SpringFamily bend;       // (2, 0), (0, 2)
 
     int m_width;
     int m_height;
     float m_spacing;
     float m_totalMass;
 
+    // Tuning read by UpdatePhysics
+    float dragCoefficient;
+    float kRepel;             // Self-collision repulsion stiffness
+
+    // Integrate the springs implicitly with projective dynamics instead of explicit
+    // spring forces. The families' spring constants are the weights; their damping is unused.
+    // Drag, gravity and self-collision stay explicit external forces.
+    bool projectiveDynamics;
+    ProjectiveDynamics pdSolver;
+
+    // Energies, momentum and strain of the last UpdatePhysics (projective dynamics: the
+    // elastic terms come from its last local step)
+    SimDiagnostics diagnostics;
+
+    // Obstacles the cloth collides with (the ground plane by default)
+    ColliderSet colliders;
+
+    // Optional spatially varying wind added to the uniform wind (not owned)
+    const WindField* windField;
+
+    // Upload positions only and let the vertex shader (Shader/cloth_gpunormal.vert) rebuild
+    // the normals. Physics then skips all normal work. Draw with the matching shader.
+    bool gpuNormals;
+
+    // Also upload the positions of the previous fixed physics tick (attribute 2), so
+    // cloth_interp.vert can blend between the last two ticks
+    bool interpolate;
+    std::vector<glm::vec3> previousPositions;
+
+    // Upload 8-byte PackedVertex data instead of 6 floats per vertex.
+    // Draw with Shader/cloth_quantized.vert (ignored while gpuNormals is set).
+    bool quantizedVertices;
+    std::vector<PackedVertex> packedData;
+    PackedBounds packedBounds;
+
     // OpenGL specific data
     std::vector<float> vertexData;     // Stores alternating PosX, PosY, PosZ, NormX, NormY, NormZ
     std::vector<unsigned int> indices; // Defines which vertices make up which triangles
 
-    unsigned int VAO, VBO, EBO;
+    unsigned int VAO, VBO, EBO; // Created on the first Draw, so the physics runs without a GL context
+    bool vaoPacked;             // VAO currently uses the packed layout
+    unsigned int previousVBO;
+
+    // GPU normal path: positions-only VBO, also read as a texture buffer, plus the
+    // per-vertex triangle adjacency (CSR offsets and the other two corners of each face)
+    std::vector<float> positionData;
+    unsigned int positionVAO, positionVBO, positionTexture;
+    unsigned int adjacencyOffsetBuffer, adjacencyOffsetTexture;
+    unsigned int adjacencyBuffer, adjacencyTexture;
 
     Cloth(int width, int height, float spacing, float totalMass);
     ~Cloth();
@@ -31,7 +84,31 @@ public:
     void Draw(unsigned int shaderProgram);
     void Reset();
 
+    void SetSpringConstants(float structural, float shear, float bend);
+    void ScaleStiffness(float springScale, float dampingScale);
+
+    // Spring forces of all families (UpdatePhysics calls this; the parachute drives the canopy itself).
+    // Adds the spring energies and strains to diagnostics if given.
+    void ComputeSpringForces(SimDiagnostics* diagnostics = nullptr);
+
+    // Largest length / rest length over all springs
+    float MaxStretch() const;
+
+    // Call before each fixed physics tick when interpolating
+    void StorePreviousPositions();
+
 private:
+    // Calls visit(a, b) for every pair of the family with direction (DX, DY).
+    // The partner is a compile-time offset from the particle, so no indices are loaded.
+    template <int DX, int DY, typename Visit>
+    void ForEachSpring(Visit visit) const;
+
+    // Rebuilds pdSolver's springs when the family constants changed
+    void SyncProjectiveSprings();
+    float m_pdWeights[3];
+
     void SetupMesh();
+    void SetupAdjacency();
     void UpdateMesh();
+    void DeleteMesh();
 };
\ No newline at end of file
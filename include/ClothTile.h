@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Particle.h"
+#include "Collider.h"
+#include "SpringDamper.h"
+
+// A width x height cloth grid laid out like Cloth::InitCloth (x fastest, top row pinned).
+// Positions and velocities are double buffered: a step reads one buffer and writes the other,
+// so tiles (possibly in different processes) only need one barrier per step.
+// The arrays are not owned; they usually live in shared memory.
+struct ClothGridState {
+    int width, height;
+    glm::vec3* positions[2];
+    glm::vec3* velocities[2];
+
+    size_t Index(int x, int y) const { return (size_t)y * width + x; }
+};
+
+// Simulates the particles in [x0, x1) x [y0, y1) of a ClothGridState.
+// Every particle gathers its own spring and drag forces, reading neighbours up to kHalo cells
+// outside the tile. The terms are summed in the same order whatever the tiling, so a tiled
+// run matches a single-tile run exactly. Self-collision is not modelled.
+class ClothTile {
+public:
+    static const int kHalo = 2; // Bending springs reach two particles away
+
+    int x0, y0, x1, y1;
+    float spacing;
+    float particleMass;
+
+    // Same defaults as Cloth (see GridClothKernel.h)
+    SpringFamily structural; // (1, 0), (0, 1)
+    SpringFamily shear;      // (1, 1), (-1, 1)
+    SpringFamily bend;       // (2, 0), (0, 2)
+    float dragCoefficient;
+    float airDensity;
+
+    ColliderSet colliders; // The ground plane by default
+
+    ClothTile(int x0, int y0, int x1, int y1, float spacing, float particleMass);
+
+    // Fills buffer 0 with the InitCloth rest pose (centered, hanging down from y = 5)
+    static void InitGrid(ClothGridState& state, float spacing);
+
+    // Advances the tile's particles: reads buffer `read`, writes buffer 1 - read
+    void Step(const ClothGridState& state, int read, float deltaTime, const glm::vec3& windVelocity);
+
+private:
+    std::vector<Particle> m_row; // Scratch particles for one row of the tile
+    std::vector<glm::vec3> m_points;
+    std::vector<float> m_distances;
+    std::vector<glm::vec3> m_normals;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+class Particle;
+
+// Signed distances sampled on a regular voxel grid (negative inside)
+class SignedDistanceField {
+public:
+    glm::ivec3 resolution; // Samples along each axis
+    glm::vec3 origin;      // World position of sample (0, 0, 0)
+    float cellSize;
+    std::vector<float> distances; // x fastest, then y, then z
+
+    SignedDistanceField(); // Empty: no samples, no surface
+
+    // Voxelizes a closed triangle mesh. The grid covers the mesh bounds plus padding, with
+    // at least two samples per axis. Inside/outside comes from the generalized winding
+    // number, so small holes are tolerated. An empty mesh or cellSize <= 0 gives an empty field.
+    static SignedDistanceField FromMesh(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices, float cellSize, float padding);
+
+    // At least two samples per axis, all present (Sample interpolates between neighbours)
+    bool IsValid() const {
+        return resolution.x >= 2 && resolution.y >= 2 && resolution.z >= 2 && cellSize > 0.0f &&
+               distances.size() == (size_t)resolution.x * resolution.y * resolution.z;
+    }
+
+    // Trilinear lookup; points outside the grid add their distance to the grid box.
+    // An invalid field returns FLT_MAX (no surface).
+    float Sample(const glm::vec3& p) const;
+    glm::vec3 Gradient(const glm::vec3& p) const;
+
+private:
+    float At(int x, int y, int z) const {
+        return distances[(z * resolution.y + y) * resolution.x + x];
+    }
+};
+
+enum class ColliderType { Plane, Sphere, Capsule, Box, Field };
+
+struct Collider {
+    ColliderType type;
+    glm::vec3 a;           // Plane point, sphere/box center, capsule start, field offset
+    glm::vec3 b;           // Plane normal, capsule end
+    glm::vec3 halfExtents; // Box
+    glm::mat3 rotation;    // Box orientation (columns are the box axes)
+    float radius;          // Sphere and capsule
+    const SignedDistanceField* field; // Not owned
+};
+
+// Static obstacles queried as one batch over all particles (and over a rigid body's contact points)
+class ColliderSet {
+public:
+    std::vector<Collider> colliders;
+
+    void AddPlane(const glm::vec3& point, const glm::vec3& normal);
+    void AddSphere(const glm::vec3& center, float radius);
+    void AddCapsule(const glm::vec3& start, const glm::vec3& end, float radius);
+    void AddBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::mat3& rotation = glm::mat3(1.0f));
+    void AddField(const SignedDistanceField* field, const glm::vec3& offset = glm::vec3(0.0f)); // Rejects invalid fields
+    void Clear() { colliders.clear(); }
+
+    // Distance and outward normal of the closest collider for every point.
+    // The collider loop is outermost so each inner loop is a branch-free sweep over the points.
+    void Query(const glm::vec3* points, size_t count, float* distances, glm::vec3* normals) const;
+
+    // Query + Respond for every particle, skipping fixed ones
+    void ResolveParticles(Particle* const* particles, size_t count, float thickness, float restitution, float friction) const;
+
+    // Pushes a particle back to `thickness` above the surface, reflecting the normal
+    // velocity with restitution and scaling the tangential velocity by (1 - friction)
+    static void Respond(Particle& p, float distance, const glm::vec3& normal, float thickness, float restitution, float friction);
+
+    // The flat ground every scene used to hard-code
+    static ColliderSet Ground(float groundY = -10.0f);
+
+private:
+    // Scratch arrays reused between ResolveParticles calls
+    mutable std::vector<glm::vec3> m_points;
+    mutable std::vector<float> m_distances;
+    mutable std::vector<glm::vec3> m_normals;
+};
@@ -3,32 +3,48 @@
 #include <vector>
 #include <glad/glad.h>
 #include "Particle.h"
-#include "SpringDamper.h"
+#include "RigidBody.h"
+#include "Collider.h"
 
 class Cube {
 public:
+    // The crate is a single rigid body. The 8 corner particles are kinematic
+    // attachment points: springs apply forces to them and the body moves them.
+    RigidBody body;
     std::vector<Particle*> particles;
-    std::vector<SpringDamper*> springs;
+    float halfSize;
 
-    // OpenGL rendering state for solid faces
+    // OpenGL rendering state for solid faces (created on the first Draw)
     unsigned int VAO, VBO, EBO;
     std::vector<float> vertexData;
     std::vector<unsigned int> indices;
 
+    // Corner positions at the previous fixed physics tick (attribute 2, see Cloth::interpolate)
+    bool interpolate;
+    unsigned int previousVBO;
+    std::vector<glm::vec3> previousPositions;
+
     Cube(glm::vec3 center, float size, float mass);
 
     ~Cube() {
         for (auto p : particles) delete p;
-        for (auto s : springs) delete s;
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
+        if (VAO) {
+            glDeleteVertexArrays(1, &VAO);
+            glDeleteBuffers(1, &VBO);
+            glDeleteBuffers(1, &EBO);
+            glDeleteBuffers(1, &previousVBO);
+        }
     }
 
-    void UpdatePhysics(float deltaTime);
+    void ClearForces();
+    // Gathers corner forces onto the body, integrates it against the colliders and moves the corners
+    void Integrate(float deltaTime, const ColliderSet& colliders);
+    void UpdatePhysics(float deltaTime, const ColliderSet& colliders);
+    void SetFixed(bool fixed);
+    void StorePreviousPositions();
     void Draw(unsigned int shaderProgram);
 
 private:
     void SetupMesh();
     void UpdateMesh();
-};
\ No newline at end of file
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Particle.h"
+#include "SpringDamper.h"
+#include "Collider.h"
+#include "WindField.h"
+
+// Fast path for the regular width x height sheet built by Cloth::InitCloth (layout, stencil
+// and force laws shared with ClothTile, see GridClothKernel.h).
+// No spring or triangle objects are stored: both are implied by (x, y). Particles live in
+// structure-of-arrays form and every kernel runs row by row over contiguous x with fixed
+// offsets to the neighbours, so the inner loops vectorise.
+class GridCloth {
+public:
+    int width, height;
+    float spacing;
+    float totalMass;
+
+    // Particle state, index y * width + x
+    std::vector<float> px, py, pz;
+    std::vector<float> vx, vy, vz;
+    std::vector<unsigned char> pinned;
+
+    // Same families and tuning as Cloth
+    SpringFamily structural; // (1, 0), (0, 1)
+    SpringFamily shear;      // (1, 1), (-1, 1)
+    SpringFamily bend;       // (2, 0), (0, 2)
+    float dragCoefficient;
+    float kRepel;
+    ColliderSet colliders;
+    const WindField* windField; // Not owned
+
+    GridCloth(int width, int height, float spacing, float totalMass);
+    ~GridCloth();
+
+    void UpdatePhysics(float deltaTime, const glm::vec3& windVelocity);
+    void Draw(unsigned int shaderProgram);
+    void Reset(); // Rest pose, top row pinned
+
+    size_t Index(int x, int y) const { return (size_t)y * width + x; }
+
+private:
+    float m_particleMass;
+    std::vector<float> m_fx, m_fy, m_fz;
+    std::vector<float> m_rowX, m_rowY, m_rowZ; // One row of spring forces
+
+    // Per-particle drag of the two triangles of each cell, on a grid padded by one
+    // empty cell on every side so the gather needs no bounds checks
+    int m_cellStride;
+    std::vector<float> m_drag1x, m_drag1y, m_drag1z; // (TL, BL, TR)
+    std::vector<float> m_drag2x, m_drag2y, m_drag2z; // (TR, BL, BR)
+
+    std::vector<unsigned int> m_sorted; // Self-collision sweep order
+    std::vector<glm::vec3> m_points;
+    std::vector<float> m_distances;
+    std::vector<glm::vec3> m_normals;
+
+    // OpenGL (created on the first Draw)
+    unsigned int VAO, VBO, EBO;
+    std::vector<float> vertexData;
+    std::vector<unsigned int> indices;
+
+    template <int DX, int DY>
+    void RowSprings(int y, const SpringFamily& family);
+    void ComputeCellDrag(const glm::vec3& windVelocity);
+    void GatherDrag(int y);
+    void SelfCollide();
+
+    void SetupMesh();
+    void UpdateMesh();
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp> // For glm::root_two
+#include "SpringDamper.h"
+
+// The regular width x height sheet laid out like Cloth::InitCloth, shared by the two grid
+// solvers so they simulate the same cloth: GridCloth (the whole sheet as structure of
+// arrays, springs scattered row by row) and ClothTile (tiles of a shared grid, every
+// particle gathering its own terms). Header-only, so the multi-process tool links nothing new.
+
+// Rest pose of particle (x, y): centered on x = 0, hanging down from y = 5, with a small
+// ripple in z to break the symmetry
+inline glm::vec3 GridRestPosition(int x, int y, int width, float spacing) {
+    return glm::vec3((x - width / 2.0f) * spacing, -y * spacing + 5.0f, std::sin(x * 0.5f) * 0.1f);
+}
+
+// Cloth's spring families for a grid spacing
+inline void GridSpringFamilies(float spacing, SpringFamily& structural, SpringFamily& shear, SpringFamily& bend) {
+    structural = { 450.0f, 0.5f, spacing };
+    shear = { 100.0f, 0.5f, glm::root_two<float>() * spacing };
+    bend = { 200.0f, 0.5f, 2.0f * spacing };
+}
+
+// Cloth's drag and collider response
+const float kGridDragCoefficient = 1.5f;
+const float kGridAirDensity = 1.225f;
+const float kGridColliderThickness = 0.05f;
+const float kGridColliderRestitution = 0.2f;
+const float kGridColliderFriction = 0.8f;
+
+// Spring-damper law on plain vectors: the force on the first particle is
+// GridSpringForceScale(...) * e, for the edge e = x2 - x1 and dv = v2 - v1. Also returns |e|;
+// coincident particles exert no force. One reciprocal square root instead of SpringDamper's
+// divide by the length, so the grids agree with Cloth to rounding, not bit for bit.
+inline float GridSpringForceScale(const glm::vec3& e, const glm::vec3& dv, float ks, float kd, float restLength, float& length) {
+    float l2 = glm::dot(e, e);
+    float invLength = l2 > 0.0f ? 1.0f / std::sqrt(l2) : 0.0f;
+    length = l2 * invLength;
+    return (ks * (length - restLength) + kd * glm::dot(dv, e) * invLength) * invLength;
+}
+
+// Triangle::ComputeDragPerParticle on plain vectors: corner positions a, b, c and the sum of
+// their velocities. Returns the drag on each vertex and stores the unnormalized normal in
+// crossProduct; zero relative velocity or zero area give zero force.
+inline glm::vec3 GridFaceDrag(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& velocitySum,
+                              const glm::vec3& windVelocity, float dragScale, glm::vec3& crossProduct) {
+    crossProduct = glm::cross(b - a, c - a);
+    glm::vec3 v_rel = velocitySum * (1.0f / 3.0f) - windVelocity;
+    float crossLength2 = glm::dot(crossProduct, crossProduct);
+    float invCrossLength = crossLength2 > 0.0f ? 1.0f / std::sqrt(crossLength2) : 0.0f;
+    return (-dragScale * glm::length(v_rel) * glm::dot(v_rel, crossProduct) * invCrossLength) * crossProduct;
+}
+
+// Springs from (x, y) to (x + dx, y + dy), one direction per entry and in this order:
+// structural, shear, bending (0, 1 and 2 index the families). A scattering solver visits
+// each spring once from its first particle; a gathering one also visits (-dx, -dy).
+struct GridSpringDirection {
+    int dx, dy;
+    int family;
+};
+constexpr int kGridSpringDirections = 6;
+constexpr GridSpringDirection kGridSprings[kGridSpringDirections] = {
+    { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 1 }, { -1, 1, 1 }, { 2, 0, 2 }, { 0, 2, 2 },
+};
+
+// The two triangles of the cell whose top-left particle is tl, as in InitCloth:
+// (TL, BL, TR) and (TR, BL, BR)
+inline void GridCellFaces(size_t tl, int width, size_t faces[2][3]) {
+    size_t tr = tl + 1, bl = tl + width, br = bl + 1;
+    faces[0][0] = tl; faces[0][1] = bl; faces[0][2] = tr;
+    faces[1][0] = tr; faces[1][1] = bl; faces[1][2] = br;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "SparseMatrix.h"
+#include "SkylineCholesky.h"
+
+// Geometric multigrid for symmetric positive definite systems on a regular width x height
+// grid (unknown y * width + x, the particle order of Cloth::InitCloth).
+// Iterative solvers only move stiffness one spring per iteration across the sheet; the
+// coarse levels carry the long-range part of the error, so the iteration count stays
+// nearly constant as the resolution grows.
+//  - Each level halves the grid: coarse node (i, j) sits on fine node (2i, 2j), and the
+//    prolongation P interpolates bilinearly between coarse nodes (restriction is P^T).
+//  - Coarse operators are Galerkin products P^T A P, so pins and any spring weights carry
+//    over without rediscretizing.
+//  - Smoothing is l1-Jacobi (parallel, convergent for any SPD matrix); the coarsest
+//    level is solved directly with a skyline Cholesky factor.
+class GridMultigrid {
+public:
+    int smoothingSweeps; // Jacobi sweeps before and after each coarse correction
+    int coarsestSize;    // Stop coarsening once width or height is at most this
+
+    GridMultigrid();
+
+    // Builds the hierarchy for A (width * height rows). Returns false if the coarsest
+    // level could not be factored.
+    bool Build(int width, int height, const SparseMatrix& A);
+
+    bool Valid() const { return m_valid; }
+    int Levels() const { return (int)m_levels.size(); }
+
+    // One V-cycle towards A x = b, starting from x (use x = 0 as a preconditioner)
+    void VCycle(const glm::vec3* b, glm::vec3* x);
+
+    // Conjugate gradients preconditioned with one V-cycle per iteration. x holds the
+    // initial guess; stops once |b - A x| <= tolerance * |b|. Returns the iterations used.
+    int SolvePCG(const glm::vec3* b, glm::vec3* x, int maxIterations, float tolerance);
+
+private:
+    struct Level {
+        int width, height;
+        SparseMatrix A;
+        SparseMatrix P, R;             // From / to the next coarser level
+        std::vector<float> invDiagonal; // 1 / sum_j |A(i, j)| (l1-Jacobi)
+        std::vector<glm::vec3> b, x, r; // Scratch for the V-cycle (b and x unused on level 0)
+    };
+
+    std::vector<Level> m_levels;
+    SkylineCholesky m_coarsest;
+    bool m_valid;
+
+    // PCG scratch
+    std::vector<glm::vec3> m_residual, m_preconditioned, m_direction, m_product;
+
+    void Cycle(size_t level, const glm::vec3* b, glm::vec3* x);
+    void Smooth(Level& level, const glm::vec3* b, glm::vec3* x);
+};
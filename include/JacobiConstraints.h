@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Particle.h"
+
+// Minimum-separation constraints |x_a - x_b| >= distance, projected Jacobi style: every
+// iteration reads the previous iterate and writes a separate buffer, with each particle
+// gathering (and averaging) the corrections of its own constraints. No two threads write
+// the same particle, so iterations run in parallel; unlike an in-place Gauss-Seidel pass,
+// the result does not depend on the constraint order.
+// Plain Jacobi converges slower than Gauss-Seidel, so the iterates are accelerated by the
+// Chebyshev semi-iterative method (Wang 2015): x_{k+1} = w_{k+1} (x^_{k+1} - x_{k-1}) + x_{k-1},
+// with w_{k+1} = 4 / (4 - rho^2 w_k) for the spectral radius rho of the plain iteration.
+class JacobiConstraints {
+public:
+    struct Constraint {
+        unsigned int a, b;
+        float distance;
+    };
+
+    int iterations;
+    float relaxation;     // Scales the averaged Jacobi correction (gamma)
+    float spectralRadius; // rho; 0 disables the Chebyshev weighting
+    int chebyshevDelay;   // Plain iterations before the weighting starts (contacts settle first)
+
+    JacobiConstraints();
+
+    void Clear() { m_constraints.clear(); }
+    void Add(unsigned int a, unsigned int b, float distance) { m_constraints.push_back({ a, b, distance }); }
+    size_t Size() const { return m_constraints.size(); }
+
+    // Pushes the particles apart until the constraints hold; fixed particles don't move.
+    // Also removes the approach velocity of every pair still in contact (within 1% of its
+    // distance); pairs the iterations separated keep their velocities.
+    void Solve(Particle* const* particles, size_t count);
+
+private:
+    std::vector<Constraint> m_constraints;
+
+    // Constraints touching each particle, CSR: [m_offsets[i], m_offsets[i + 1])
+    std::vector<unsigned int> m_offsets;
+    std::vector<unsigned int> m_particleConstraints;
+
+    std::vector<glm::vec3> m_previous, m_current, m_next; // x_{k-1}, x_k, x_{k+1}
+    std::vector<glm::vec3> m_velocityChange;
+    std::vector<float> m_weights; // 1 for free particles, 0 for fixed ones
+
+    void BuildAdjacency(size_t count);
+};
@@ -7,6 +7,11 @@
 #include "Cloth.h"
 #include "Cube.h"
 #include "SpringDamper.h"
+#include "Collider.h"
+#include "WindField.h"
+#include "JacobiConstraints.h"
+#include "RopeChains.h"
+#include "SimDiagnostics.h"
 
 class ParachuteSystem {
 public:
@@ -17,9 +22,42 @@ public:
     bool falling;
     glm::vec3 m_dropPosition;
 
-    // OpenGL Line Rendering state for ropes
-    unsigned int lineVAO, lineVBO;
-    std::vector<float> lineVertexData;
+    // Energies, momentum and strain of the last UpdatePhysics (canopy, ropes and crate)
+    SimDiagnostics diagnostics;
+
+    // Static obstacles (the ground plane by default) and the crate's box, moved every step
+    ColliderSet colliders;
+    ColliderSet crateCollider;
+
+    // Optional spatially varying wind added to the uniform wind (not owned)
+    const WindField* windField;
+
+    // Canopy drag (Scene 1 cloth uses its own)
+    float dragCoefficient;
+
+    // Canopy self-collision: the sequential in-place pushes, or (when set) the same pairs
+    // solved by parallel Chebyshev-accelerated Jacobi iterations
+    bool jacobiSelfCollision;
+    JacobiConstraints selfCollisionSolver;
+
+    // Ropes: the stiff rope springs (plus velocity damping), or (when set) the same chains as
+    // inextensible links solved exactly every step. The chains are built by CreateRopes.
+    bool exactRopes;
+    RopeChains ropeSolver;
+
+    // Rope line mesh: every particle a rope touches is one vertex, shared by its two
+    // segments, and each rope spring is an index pair. Built by CreateRopes; only the
+    // positions are streamed per frame, into arrays sized once.
+    std::vector<Particle*> ropeVertices;
+    std::vector<unsigned int> ropeLineIndices;
+
+    // OpenGL Line Rendering state for ropes (created on the first DrawLines)
+    unsigned int lineVAO, lineVBO, lineEBO;
+    std::vector<float> lineVertexData; // Pos and previous tick pos per rope vertex (the normal is constant)
+
+    // Rope vertex positions at the previous fixed physics tick (see Cloth::interpolate)
+    bool interpolate;
+    std::vector<glm::vec3> previousRopePositions;
 
     // Constructor & Destructor
     ParachuteSystem(glm::vec3 dropPosition);
@@ -31,6 +69,7 @@ public:
     void Reset();
     void CreateRopes(); // Helper to build rope chains
     void SetupLineMesh();
+    void StorePreviousPositions(); // Canopy, crate and ropes
     void DrawLines(unsigned int shaderProgram);
     void DrawCrate(unsigned int shaderProgram);
 };
\ No newline at end of file
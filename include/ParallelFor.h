@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Settings shared by every ParallelFor / ParallelReduce
+struct ParallelSettings {
+    size_t threadCount = 0;               // 0 = one per hardware thread
+    bool deterministic = false;           // Reductions independent of threadCount (see ParallelReduce)
+    size_t deterministicChunkSize = 1024; // Reduction chunk in deterministic mode
+    size_t minBlockSizeOverride = 0;      // Nonzero replaces every loop's minBlockSize (tests split small scenes)
+};
+
+inline ParallelSettings& GetParallelSettings() {
+    static ParallelSettings settings;
+    return settings;
+}
+
+inline size_t ParallelThreadCount() {
+    size_t threads = GetParallelSettings().threadCount;
+    return threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+inline size_t ParallelMinBlockSize(size_t minBlockSize) {
+    size_t override = GetParallelSettings().minBlockSizeOverride;
+    return std::max<size_t>(override > 0 ? override : minBlockSize, 1);
+}
+
+// Worker threads kept alive for the whole program, so a parallel loop costs a wake-up
+// instead of a thread start and join (solvers run several loops per substep).
+// Workers are added when threadCount grows and are never stopped before exit.
+class ParallelPool {
+public:
+    static ParallelPool& Get() {
+        static ParallelPool pool;
+        return pool;
+    }
+
+    // True on a worker (or the caller) while it runs a task: nested loops run serially there
+    static bool& InTask() {
+        static thread_local bool inTask = false;
+        return inTask;
+    }
+
+    // Calls task(t) for every t in [0, taskCount) on up to threadCount threads, the calling
+    // thread included, and returns once all calls have finished
+    void Run(size_t taskCount, size_t threadCount, const std::function<void(size_t)>& task) {
+        std::lock_guard<std::mutex> run(m_runMutex); // One run at a time
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Stragglers of the previous run must leave before its counters are reused
+        m_done.wait(lock, [this]() { return m_busy == 0; });
+        while (m_workers.size() + 1 < threadCount) {
+            m_workers.emplace_back([this]() { WorkerLoop(); });
+        }
+        m_task = &task;
+        m_taskCount = taskCount;
+        m_next = 0;
+        m_finished = 0;
+        m_generation++;
+        lock.unlock();
+        m_wake.notify_all();
+
+        RunTasks();
+
+        lock.lock();
+        m_done.wait(lock, [this]() { return m_finished == m_taskCount && m_busy == 0; });
+        m_task = nullptr;
+    }
+
+    ~ParallelPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers) worker.join();
+    }
+
+private:
+    std::mutex m_runMutex, m_mutex;
+    std::condition_variable m_wake, m_done;
+    std::vector<std::thread> m_workers;
+    const std::function<void(size_t)>* m_task = nullptr;
+    size_t m_taskCount = 0;
+    std::atomic<size_t> m_next{ 0 };
+    size_t m_finished = 0;       // Tasks completed in this run (under m_mutex)
+    size_t m_busy = 0;           // Workers currently inside RunTasks (under m_mutex)
+    unsigned long long m_generation = 0;
+    bool m_stop = false;
+
+    ParallelPool() = default;
+
+    // Claims tasks until none are left
+    void RunTasks() {
+        InTask() = true;
+        size_t done = 0;
+        for (size_t t = m_next++; t < m_taskCount; t = m_next++, done++) (*m_task)(t);
+        InTask() = false;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished += done;
+        if (m_finished == m_taskCount) m_done.notify_all();
+    }
+
+    void WorkerLoop() {
+        unsigned long long seen = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [&]() { return m_stop || (m_generation != seen && m_task); });
+            if (m_stop) return;
+            seen = m_generation;
+            m_busy++;
+            lock.unlock();
+            RunTasks();
+            lock.lock();
+            if (--m_busy == 0) m_done.notify_all();
+        }
+    }
+};
+
+// Splits [begin, end) into one contiguous block per thread and calls
+// body(blockBegin, blockEnd) for each block on the ParallelPool. Blocks must not write shared data.
+// minBlockSize keeps small loops (run many times per frame) from paying for waking the workers.
+// Loops that only write their own elements give the same result for any thread count;
+// sums across elements must go through ParallelReduce.
+template <typename Body>
+void ParallelFor(size_t begin, size_t end, const Body& body, size_t minBlockSize = 1) {
+    size_t count = end > begin ? end - begin : 0;
+    size_t threadCount = ParallelThreadCount();
+    threadCount = std::min(threadCount, count / ParallelMinBlockSize(minBlockSize));
+    if (threadCount <= 1 || ParallelPool::InTask()) {
+        if (count > 0) body(begin, end);
+        return;
+    }
+
+    size_t blockSize = (count + threadCount - 1) / threadCount;
+    size_t blockCount = (count + blockSize - 1) / blockSize;
+    ParallelPool::Get().Run(blockCount, threadCount, [&](size_t block) {
+        size_t blockBegin = begin + block * blockSize;
+        body(blockBegin, std::min(end, blockBegin + blockSize));
+    });
+}
+
+// Reduces [begin, end): body(chunkBegin, chunkEnd) returns the partial result of one chunk
+// (accumulated in index order), and the partials are folded with combine in chunk order.
+// By default there is one chunk per thread, so float sums change with the thread count.
+// In deterministic mode the chunks have a fixed size instead, which makes the partition
+// and the combine order (and so the bits of the result) independent of the thread count.
+template <typename T, typename Body, typename Combine>
+T ParallelReduce(size_t begin, size_t end, T identity, const Body& body, const Combine& combine,
+                 size_t minBlockSize = 1) {
+    size_t count = end > begin ? end - begin : 0;
+    if (count == 0) return identity;
+
+    const ParallelSettings& settings = GetParallelSettings();
+    size_t chunkSize;
+    if (settings.deterministic) {
+        chunkSize = std::max<size_t>(settings.deterministicChunkSize, 1);
+    } else {
+        size_t threadCount = std::min(ParallelThreadCount(), count / ParallelMinBlockSize(minBlockSize));
+        chunkSize = (count + std::max<size_t>(threadCount, 1) - 1) / std::max<size_t>(threadCount, 1);
+    }
+    size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    std::vector<T> partials(chunkCount, identity);
+    // Chunks are split across threads like any loop; each chunk writes only its own partial
+    size_t minChunks = std::max<size_t>(1, ParallelMinBlockSize(minBlockSize) / chunkSize);
+    ParallelFor(0, chunkCount, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; c++) {
+            size_t first = begin + c * chunkSize;
+            partials[c] = body(first, std::min(end, first + chunkSize));
+        }
+    }, minChunks);
+
+    T result = identity;
+    for (const T& partial : partials) result = combine(result, partial);
+    return result;
+}
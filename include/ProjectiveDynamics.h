@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Particle.h"
+#include "SkylineCholesky.h"
+#include "GridMultigrid.h"
+#include "SimDiagnostics.h"
+
+// Implicit spring solver by projective dynamics (Bouaziz et al. 2014, mass-spring form of
+// Liu et al. 2013). Each step minimises
+//   sum_i m_i / (2 h^2) |q_i - y_i|^2 + sum_s w_s / 2 |(q_b - q_a) - d_s|^2
+// by alternating a local step (d_s = the spring's current direction at rest length, one
+// spring at a time, in parallel) and a global step (one solve with the constant matrix
+// M / h^2 + L). The matrix only depends on the topology, the weights, the masses, the pins
+// and h, so it is factored once and reused until one of them changes. Any change of h
+// refactors, so drive it with a constant step (the app only enables it with the fixed-rate
+// loop); then only new pins, masses or springs refactor.
+// On large regular grids the band factor grows as width^3; SetGrid plus multigrid = true
+// switches the global step to multigrid-preconditioned CG, warm-started from the iterate.
+// Springs have no damping here: the implicit step itself dissipates energy.
+class ProjectiveDynamics {
+public:
+    struct Spring {
+        unsigned int a, b;
+        float weight;     // The spring constant
+        float restLength;
+    };
+
+    int iterations; // Local/global iterations per step
+
+    bool multigrid;           // Global step by GridMultigrid PCG (needs SetGrid) instead of Cholesky
+    int multigridIterations;  // PCG iteration cap per global step
+    float multigridTolerance; // Relative residual to stop at
+
+    ProjectiveDynamics();
+
+    // Replaces the springs (forces a refactor). Row profiles follow the particle order,
+    // so grid-ordered particles give a band of about 2 * width.
+    void SetSprings(const std::vector<Spring>& springs);
+
+    // Declares the particles as a width x height grid in row order (required for multigrid)
+    void SetGrid(int width, int height);
+    const std::vector<Spring>& Springs() const { return m_springs; }
+
+    // Advances positions and velocities by one implicit step. forceAccumulator holds the
+    // external forces (gravity, drag, repulsion); fixed particles don't move.
+    // If given, diagnostics receives the elastic energy and max strain of the last local step.
+    void Step(Particle* const* particles, size_t count, float deltaTime, SimDiagnostics* diagnostics = nullptr);
+
+    size_t FactorCount() const { return m_factorCount; } // Number of refactorizations so far
+    int LastSolveIterations() const { return m_lastSolveIterations; } // PCG iterations in the last global step
+
+private:
+    std::vector<Spring> m_springs;
+    SkylineCholesky m_solver;
+    GridMultigrid m_multigrid;
+    int m_gridWidth, m_gridHeight;
+    size_t m_factorCount;
+    int m_lastSolveIterations;
+
+    // State the current factor was built for
+    bool m_factorValid;
+    bool m_factorMultigrid;
+    float m_factorDeltaTime;
+    std::vector<unsigned char> m_factorPinned;
+    std::vector<float> m_factorMass;
+
+    // Scratch
+    std::vector<glm::vec3> m_inertial;    // y = x + h v + h^2 / m f_ext
+    std::vector<glm::vec3> m_projections; // d_s
+    std::vector<glm::vec3> m_positions;   // The iterate q
+    std::vector<glm::vec3> m_rhs;
+
+    bool UseMultigrid(size_t count) const;
+    bool NeedsFactor(Particle* const* particles, size_t count, float deltaTime) const;
+    void Factor(Particle* const* particles, size_t count, float deltaTime);
+};
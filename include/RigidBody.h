@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class Particle;
+class ColliderSet;
+
+class RigidBody {
+public:
+    // Core physical properties (position is the center of mass)
+    glm::vec3 position;
+    glm::quat orientation;
+    glm::vec3 velocity;
+    glm::vec3 angularMomentum; // World space; angular velocity is derived from it
+    glm::vec3 angularVelocity;
+
+    glm::vec3 forceAccumulator;
+    glm::vec3 torqueAccumulator;
+
+    float mass;
+    glm::mat3 inverseInertiaBody; // Inverse inertia tensor in body space
+    bool isFixed;
+
+    // Points in body space used for ground contact and for driving attachment particles
+    std::vector<glm::vec3> localPoints;
+
+    // Constructor
+    RigidBody(glm::vec3 initialPosition, float bodyMass, const glm::mat3& inertiaBody);
+
+    // Physics methods
+    void ApplyForce(const glm::vec3& force);
+    void ApplyForceAtPoint(const glm::vec3& force, const glm::vec3& worldPoint);
+    void ApplyImpulseAtPoint(const glm::vec3& impulse, const glm::vec3& worldPoint);
+    void ClearForces();
+
+    glm::mat3 GetInverseInertiaWorld() const;
+    glm::vec3 GetPointPosition(size_t i) const;
+    glm::vec3 GetVelocityAtPoint(const glm::vec3& worldPoint) const;
+
+    // Semi-implicit Euler on linear and angular momentum, renormalizing the orientation
+    void Update(float deltaTime);
+
+    // Impulse-based contact for every local point inside a collider (planes, spheres,
+    // capsules, boxes and fields alike): the body is lifted out along the deepest point's
+    // normal, then each touching point gets a normal and a friction impulse.
+    // Only the local points collide, so a collider narrower than the point spacing can poke
+    // between them (a box corner-supported on a sphere sinks its face into it).
+    void ResolveContacts(const ColliderSet& colliders, float restitution, float friction);
+
+    // Places a particle on local point i with the matching rigid velocity
+    void SyncAttachment(Particle& p, size_t i) const;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Particle.h"
+#include "RigidBody.h"
+
+struct SimDiagnostics;
+
+// Chains of inextensible links (ropes), solved exactly once per step instead of as stiff
+// springs. Link i pulls its two nodes together with an impulse lambda_i along its direction
+// n_i, and the impulses are chosen so that after the step every link's stretch speed is
+// the one that closes its length error: (J W J^T) lambda = rhs, W the nodes' inverse masses.
+// Link i only shares a node with links i - 1 and i + 1, so the matrix is tridiagonal
+// (diagonal w_i + w_i+1, off-diagonal -w_i+1 n_i.n_i+1) and the Thomas algorithm solves
+// it in O(links), however stiff the rope: no spring constant, so no substep limit.
+// The impulses are handed out as forces, so the regular semi-implicit Euler step applies them.
+// A chain's last node may be an attachment point of a rigid body, entering with the body's
+// effective inverse mass along the link. Chains sharing a body are coupled through it and
+// solved by a few block Gauss-Seidel sweeps; apart from bodies, chains must not share nodes.
+class RopeChains {
+public:
+    int iterations;           // Sweeps over the chains (one is exact when no body is shared)
+    float errorCorrection;    // Fraction of a link's length error closed per step
+    float maxCorrectionSpeed; // Caps that closing speed, so a large error doesn't become a kick
+
+    RopeChains();
+
+    void Clear();
+    // nodes[0] -> nodes.back(), joined by links of restLength. With endBody, the last node
+    // is a particle the body drives (see RigidBody::SyncAttachment).
+    void Add(const std::vector<Particle*>& nodes, float restLength, RigidBody* endBody = nullptr);
+    size_t Size() const { return m_chains.size(); }
+
+    // Adds the link forces to the nodes' force accumulators (a body's attachment particle
+    // included, which the body gathers when it integrates). Call once every other force is
+    // in; gravity is what the bodies will add themselves. Other forces on a body count only
+    // if they are already in its own accumulators. Adds each link's strain to diagnostics.
+    void ApplyForces(float deltaTime, const glm::vec3& gravity, SimDiagnostics* diagnostics = nullptr);
+
+private:
+    struct Chain {
+        size_t firstNode, nodeCount; // Range of m_nodes; links are [firstNode, firstNode + nodeCount - 1)
+        float restLength;
+        int body;                    // Index into m_bodies, or -1
+    };
+
+    // A body's velocities as they will be after the step, updated by every chain impulse
+    struct BodyState {
+        RigidBody* body;
+        glm::vec3 velocity;
+        glm::vec3 angularMomentum;
+        glm::mat3 inverseInertia;
+    };
+
+    std::vector<Chain> m_chains;
+    std::vector<Particle*> m_nodes;
+    std::vector<BodyState> m_bodies;
+
+    // Per node (the entries of a chain's last node are unused for the link arrays)
+    std::vector<glm::vec3> m_velocity;  // Predicted end-of-step velocity
+    std::vector<float> m_inverseMass;
+    std::vector<glm::vec3> m_direction; // Unit direction of the link starting at the node
+    std::vector<float> m_bias;          // Target stretch speed of that link
+    std::vector<float> m_impulse;       // Accumulated over the sweeps
+
+    // Thomas algorithm scratch, one chain at a time
+    std::vector<float> m_diagonal, m_upper, m_rhs;
+
+    void SolveChain(const Chain& chain);
+};
@@ -20,4 +20,7 @@ public:
     void setVec3(const std::string &name, const glm::vec3 &value) const { 
         glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
     }
+    void setFloat(const std::string &name, float value) const {
+        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "Particle.h"
+
+// Energy and momentum of one physics step, accumulated inside the passes that already visit
+// every particle and spring (no extra sweeps). Values describe the state at the start of
+// the step. A total energy that keeps rising without wind is the early sign of an unstable
+// step size, well before the explosion.
+struct SimDiagnostics {
+    float kineticEnergy = 0.0f;       // sum 1/2 m |v|^2 (plus rigid rotation)
+    float gravitationalEnergy = 0.0f; // sum m g y, relative to y = 0
+    float elasticEnergy = 0.0f;       // sum 1/2 ks (l - L0)^2
+    glm::vec3 momentum = glm::vec3(0.0f);
+    float maxStrain = 0.0f;           // Largest (l - L0) / L0
+
+    float TotalEnergy() const { return kineticEnergy + gravitationalEnergy + elasticEnergy; }
+
+    void Clear() { *this = SimDiagnostics(); }
+
+    void AddBody(float mass, const glm::vec3& velocity, float height, float gravity) {
+        kineticEnergy += 0.5f * mass * glm::dot(velocity, velocity);
+        gravitationalEnergy += mass * gravity * height;
+        momentum += mass * velocity;
+    }
+
+    void AddParticle(const Particle& p, float gravity) {
+        if (!p.isFixed) AddBody(p.mass, p.velocity, p.position.y, gravity);
+    }
+
+    // stretch = l - L0 of one spring
+    void AddSpring(float springConstant, float stretch, float restLength) {
+        elasticEnergy += 0.5f * springConstant * stretch * stretch;
+        maxStrain = std::max(maxStrain, stretch / restLength);
+    }
+
+    void Add(const SimDiagnostics& other) {
+        kineticEnergy += other.kineticEnergy;
+        gravitationalEnergy += other.gravitationalEnergy;
+        elasticEnergy += other.elasticEnergy;
+        momentum += other.momentum;
+        maxStrain = std::max(maxStrain, other.maxStrain);
+    }
+};
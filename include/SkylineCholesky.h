@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Cholesky factorization A = L * L^T of a symmetric positive definite matrix stored as a
+// skyline: row i keeps only the columns [firstColumn[i], i] of the lower triangle.
+// Fill-in of the factor stays inside that profile, so grid-ordered cloth matrices
+// (bandwidth about 2 * width) factor in O(n * bandwidth^2) with no extra storage.
+class SkylineCholesky {
+public:
+    SkylineCholesky();
+
+    // Sets the profile and zeroes every entry; firstColumn[i] <= i
+    void SetProfile(const std::vector<unsigned int>& firstColumn);
+
+    size_t Size() const { return m_firstColumn.size(); }
+
+    // A(row, col) += value for col <= row; col must lie inside the row's profile
+    void Add(unsigned int row, unsigned int col, double value);
+
+    // Factors in place. Returns false (and leaves the factor unusable) if A is not positive definite.
+    bool Factor();
+
+    // Solves A x = b for three right-hand sides at once (x, y, z of each vector), in place
+    void Solve(glm::vec3* b) const;
+
+private:
+    std::vector<unsigned int> m_firstColumn;
+    std::vector<size_t> m_rowStart; // Row i's entries begin at m_values[m_rowStart[i]]
+    std::vector<double> m_values;
+    mutable std::vector<glm::dvec3> m_work; // Solve scratch
+    bool m_factored;
+
+    // Index of column 0 of the row, so entry (row, col) is m_values[RowBase(row) + col]
+    size_t RowBase(unsigned int row) const { return m_rowStart[row] - m_firstColumn[row]; }
+};
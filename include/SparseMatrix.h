@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Sparse matrix in compressed rows (columns sorted within each row), applied to vectors
+// of glm::vec3 so x, y and z are solved together.
+class SparseMatrix {
+public:
+    struct Entry {
+        unsigned int row, col;
+        double value;
+    };
+
+    SparseMatrix();
+
+    // Replaces the contents; duplicate (row, col) entries are summed
+    void Build(size_t rows, size_t cols, const std::vector<Entry>& entries);
+
+    size_t Rows() const { return m_rowStart.empty() ? 0 : m_rowStart.size() - 1; }
+    size_t Cols() const { return m_cols; }
+    size_t NonZeros() const { return m_columns.size(); }
+
+    // y = A x, parallel over rows
+    void Multiply(const glm::vec3* x, glm::vec3* y) const;
+
+    // Row access for solvers: entries of row i are [RowBegin(i), RowEnd(i))
+    size_t RowBegin(size_t row) const { return m_rowStart[row]; }
+    size_t RowEnd(size_t row) const { return m_rowStart[row + 1]; }
+    unsigned int Column(size_t entry) const { return m_columns[entry]; }
+    float Value(size_t entry) const { return m_values[entry]; }
+
+    SparseMatrix Transpose() const;
+
+    // P^T A P, the Galerkin coarse operator of A for the prolongation P
+    static SparseMatrix Galerkin(const SparseMatrix& A, const SparseMatrix& P);
+
+private:
+    size_t m_cols;
+    std::vector<size_t> m_rowStart;
+    std::vector<unsigned int> m_columns;
+    std::vector<float> m_values;
+};
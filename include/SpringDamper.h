@@ -4,6 +4,7 @@
 
 // Forward declaration of Particle to avoid circular includes
 class Particle; 
+struct SimDiagnostics;
 
 class SpringDamper {
 public:
@@ -19,6 +20,14 @@ public:
     // Constructor
     SpringDamper(Particle* particle1, Particle* particle2, float ks, float kd, float initialLength);
 
-    // Calculates the forces and applies them to p1 and p2
-    void ComputeForce(); 
+    // Calculates the forces and applies them to p1 and p2 (and adds the spring's
+    // energy and strain to diagnostics if given)
+    void ComputeForce(SimDiagnostics* diagnostics = nullptr); 
+};
+
+// Constants shared by every spring of a family (grids store families, not springs)
+struct SpringFamily {
+    float springConstant;
+    float dampingFactor;
+    float restLength;
 };
\ No newline at end of file
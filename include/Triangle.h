@@ -3,20 +3,27 @@
 #include <glm/glm.hpp>
 
 class Particle;
+class WindField;
 
+// Triangle kernels for the cloth solvers: faces are index triples (or implied by a grid),
+// never stored as objects, so every function is static
 class Triangle {
 public:
-    // Pointers to the three vertices (particles) of the triangle
-    Particle* p1;
-    Particle* p2;
-    Particle* p3;
+    // Fused normal + drag for one triangle. The cross product c is computed once: it is the
+    // area-weighted normal, and since area * n = c / 2 the drag needs no normalize:
+    // F = -1/4 * airDensity * dragCoefficient * |v_rel| * (v_rel . c) * c / |c|, split over 3 vertices.
+    // dragScale is airDensity * dragCoefficient / 12 (the 1/4 and the 1/3 split folded in).
+    static void ComputeNormalAndAerodynamicForce(Particle& a, Particle& b, Particle& c, const glm::vec3& windVelocity, float dragScale,
+                                                 bool accumulateNormals = true);
 
-    // Constructor
-    Triangle(Particle* particle1, Particle* particle2, Particle* particle3);
+    // The fused kernel without writing to the particles (for gather-style assembly):
+    // returns the drag on each vertex and stores the unnormalized face normal in crossProduct
+    static glm::vec3 ComputeDragPerParticle(const Particle& a, const Particle& b, const Particle& c, const glm::vec3& windVelocity,
+                                            float dragScale, glm::vec3& crossProduct);
 
-    // Calculates the unnormalized face normal and adds it to the particles for smooth shading
-    void ComputeNormal();
-
-    // Calculates and applies aerodynamic drag forces based on wind
-    void ComputeAerodynamicForce(const glm::vec3& windVelocity, float airDensity, float dragCoefficient);
+    // Runs the fused kernel over an index-based triangle array (3 indices per triangle).
+    // Pass accumulateNormals = false when the renderer derives normals itself.
+    static void ComputeNormalsAndAerodynamics(Particle* const* particles, const unsigned int* indices, size_t triangleCount,
+                                              const glm::vec3& windVelocity, float airDensity, float dragCoefficient,
+                                              const WindField* windField = nullptr, bool accumulateNormals = true);
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class Particle;
+
+// Compact render vertex: 8 bytes instead of the 24 of the float layout.
+// The position is 3 x unorm16 inside the mesh's bounding box for this frame (under a
+// millimetre of error for a 50 m box), the normal 2 x snorm8 octahedral coordinates.
+// Decoded by Shader/cloth_quantized.vert.
+struct PackedVertex {
+    uint16_t position[3];
+    int8_t normal[2];
+};
+
+// Box the positions are quantized into; the shader gets the same values as uniforms
+struct PackedBounds {
+    glm::vec3 min;
+    glm::vec3 extent;
+};
+
+// Bounding box of the particle positions (contiguous pool or pointer array)
+PackedBounds ComputePackedBounds(const Particle* particles, size_t count);
+PackedBounds ComputePackedBounds(const Particle* const* particles, size_t count);
+
+// Packs position and normal of every particle. Uses SSE2 four vertices at a time where
+// available, with a scalar path for the rest. Normals are expected to be unit length.
+void PackVertices(const Particle* particles, size_t count, const PackedBounds& bounds, PackedVertex* out);
+void PackVertices(const Particle* const* particles, size_t count, const PackedBounds& bounds, PackedVertex* out);
+
+// Points attributes 0 (position) and 1 (normal) of the bound VAO at the bound VBO, using
+// either the 6-float layout or PackedVertex
+void SetVertexAttributes(bool packed);
+
+// Sets the boundsMin / boundsExtent uniforms of cloth_quantized.vert
+void SetPackedBoundsUniforms(unsigned int shaderProgram, const PackedBounds& bounds);
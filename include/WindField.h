@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Wind velocities stored on a regular 3D grid and sampled with trilinear interpolation.
+// The grid is regenerated at updateInterval, far less often than the physics steps.
+class WindField {
+public:
+    glm::ivec3 resolution; // Nodes along each axis
+    glm::vec3 origin;      // World position of node (0, 0, 0)
+    float cellSize;
+    std::vector<glm::vec3> velocities; // x fastest, then y, then z
+
+    // Procedural turbulence settings
+    float turbulenceStrength; // Peak speed of the curl noise
+    float noiseScale;         // Noise features per world unit
+    float timeScale;          // How fast the noise evolves
+    float updateInterval;     // Seconds between grid regenerations
+
+    WindField(glm::vec3 minCorner, glm::vec3 maxCorner, float cellSize);
+
+    // Divergence-free turbulence: curl of a noise vector potential, slices built in parallel
+    void GenerateCurlNoise(float time);
+
+    // Text file: "nx ny nz originX originY originZ cellSize" then nx*ny*nz lines of "vx vy vz".
+    // A loaded field is static; Update() no longer regenerates it.
+    bool LoadFromFile(const char* path);
+
+    // Advances the clock and regenerates the procedural grid when the interval has elapsed
+    void Update(float deltaTime);
+
+    // Trilinear lookup, clamped to the grid bounds
+    glm::vec3 Sample(const glm::vec3& p) const;
+
+private:
+    float m_time;
+    float m_sinceUpdate;
+    bool m_procedural;
+
+    size_t Index(int x, int y, int z) const {
+        return ((size_t)z * resolution.y + y) * resolution.x + x;
+    }
+};
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Particle.h"
+#include "RigidBody.h"
+#include "Collider.h"
+#include "WindField.h"
+#include "VertexPacking.h"
+
+// Spring stored by particle index so it can live in the shared pool
+struct PoolSpring {
+    unsigned int p1;
+    unsigned int p2;
+    float springConstant;
+    float dampingFactor;
+    float restLength;
+    bool active;          // False while the slot sits on the free list
+};
+
+// Triangle stored by particle index; body selects the drag coefficient
+struct PoolTriangle {
+    unsigned int p1;
+    unsigned int p2;
+    unsigned int p3;
+    unsigned int body;
+    bool active;
+};
+
+enum class BodyType { Cloth, Crate, Rope };
+
+// A body is a contiguous range of the shared pools plus its per-object tuning.
+// The phase kernels never loop per body, they look these values up per element.
+struct WorldBody {
+    BodyType type;
+    unsigned int firstParticle, particleCount;
+    unsigned int firstSpring, springCount;
+    unsigned int firstTriangle, triangleCount;
+
+    float dragCoefficient;     // 0 disables aerodynamics (normals are still accumulated)
+    float selfCollisionRadius; // 0 disables self-collision for this body
+    float kRepel;              // > 0 uses force-based repulsion, 0 uses position-based correction
+    float velocityDamping;     // Multiplied into velocity every step (1 = none)
+    float maxAcceleration;     // 0 disables the acceleration clamp
+    float groundOffset;        // Thickness kept above the colliders
+    float groundRestitution;
+    float groundFriction;
+    float tearStretch;         // Springs break beyond this multiple of their rest length (0 = never)
+    glm::vec3 color;
+    int rigidBody;             // Index into World::rigidBodies driving this body's particles, or -1
+    int parachute;             // Index into World::parachutes this body belongs to, or -1
+    int gridWidth, gridHeight; // Particle grid of a flag (0 otherwise)
+    float gridSpacing;
+    bool simulated;            // False while another level of detail stands in for this body
+    int lod;                   // Index into World's LOD records (flags and their twins), or -1
+    bool lodTwin;              // Coarse stand-in of a flag: simulated, never drawn
+    unsigned int splitCount;   // Edge splits adaptive remeshing currently has applied
+};
+
+// Canopy, crate and rope bodies that belong to one parachute
+struct WorldParachute {
+    unsigned int canopy;
+    unsigned int crate;
+    unsigned int ropes;
+    float crateHalfSize;
+};
+
+class World {
+public:
+    // particleBody value of a particle slot that is on the free list
+    static const unsigned int kFreeSlot = 0xFFFFFFFFu;
+
+    // Shared pools: every body appends into the same arrays.
+    // Topology changes at runtime reuse free-listed slots instead of compacting.
+    std::vector<Particle> particles;
+    std::vector<unsigned int> particleBody; // Owning body of each particle
+    std::vector<PoolSpring> springs;
+    std::vector<PoolTriangle> triangles;
+
+    std::vector<RigidBody> rigidBodies; // Crates; their corner particles in the pool are kinematic
+    std::vector<WorldBody> bodies;
+    std::vector<WorldParachute> parachutes;
+
+    // OpenGL specific data (one VBO for the whole pool)
+    std::vector<float> vertexData;         // PosX, PosY, PosZ, NormX, NormY, NormZ per particle
+    std::vector<unsigned int> indices;     // Triangle indices, grouped by body
+    std::vector<unsigned int> lineIndices; // Rope spring endpoints drawn as GL_LINES
+    unsigned int VAO, VBO, EBO;
+    unsigned int lineVAO, lineEBO;
+
+    // Positions at the previous fixed physics tick, uploaded as attribute 2 (see Cloth::interpolate)
+    bool interpolate;
+    std::vector<glm::vec3> previousPositions;
+    unsigned int previousVBO;
+
+    // Stream 8-byte PackedVertex data instead of 6 floats per particle; draw with
+    // Shader/cloth_quantized.vert. Toggling it re-specifies the vertex layout.
+    bool quantizedVertices;
+    std::vector<PackedVertex> packedData;
+    PackedBounds packedBounds;
+
+    int maxTearsPerStep; // Bounds the topology work done in a single step
+
+    // Assemble spring and triangle forces per particle instead of per element: each particle
+    // walks its incident springs and triangles (CSR adjacency) and sums its own force.
+    // Shared elements are evaluated once per endpoint, but no two threads ever write the
+    // same particle, so the pass runs in parallel without atomics.
+    bool gatherForces;
+
+    // Simulation level of detail for flags: beyond lodDistances[0] / [1] from the camera a
+    // coarse twin keeping every 2nd / 4th grid line is simulated instead, and the flag's own
+    // particles are interpolated from it for drawing. Torn flags stay at full resolution.
+    bool simulationLod;
+    float lodDistances[2];
+    float lodHysteresis; // Relative band around each distance in which the level is kept
+
+    // Adaptive remeshing of flags: every remeshInterval steps, interior edges whose fold
+    // (dihedral angle in radians, plus refineStrainWeight times the edge strain) exceeds
+    // refineAngle are split at their midpoint, and splits whose triangles have flattened
+    // below coarsenAngle are undone. At most maxRefinedParticles midpoints exist at once.
+    // Flags with splits neither tear nor leave LOD level 0; turning it off undoes every split.
+    bool adaptiveRemesh;
+    float refineAngle, coarsenAngle;
+    float refineStrainWeight;
+    float minEdgeLength;     // Edges shorter than twice this are not split
+    int remeshInterval;
+    int maxRefinedParticles;
+    size_t RefinedParticleCount() const { return m_splits.size(); }
+
+    // Static obstacles shared by every body (the ground plane by default)
+    ColliderSet colliders;
+
+    // Optional spatially varying wind added to the uniform wind (not owned)
+    const WindField* windField;
+
+    World();
+    ~World();
+
+    // Builders return the index of the created body / parachute
+    unsigned int AddCloth(glm::vec3 origin, int width, int height, float spacing, float totalMass);
+    unsigned int AddParachute(glm::vec3 dropPosition);
+
+    void UpdatePhysics(float deltaTime, const glm::vec3& windVelocity);
+    void ReleaseParachutes();
+    void SetTearStretch(float stretch); // Applies to every cloth body, 0 disables tearing (else >= 1.05)
+    void Reset();
+    void StorePreviousPositions(); // Call before each fixed physics tick when interpolating
+    void UpdateLod(const glm::vec3& cameraPosition); // Call before the physics ticks of a frame
+    size_t SimulatedParticleCount() const;
+    void Draw(unsigned int shaderProgram);
+
+private:
+    // Scene description kept so Reset() can rebuild the pools
+    struct SceneItem {
+        bool isParachute;
+        glm::vec3 position;
+        int width, height;
+        float spacing, totalMass;
+    };
+    std::vector<SceneItem> m_scene;
+
+    std::vector<unsigned int> m_sorted; // Scratch array for sweep and prune
+    std::vector<ColliderSet> m_crateColliders; // One box per parachute, moved every step
+    std::vector<glm::vec3> m_points;
+    std::vector<float> m_distances;
+    std::vector<glm::vec3> m_normals;
+    bool m_meshDirty;                   // Full rebuild of the index buffers (scene changed)
+    bool m_vaoPacked;                   // Layout the VAOs were set up with
+    size_t m_vboCapacity;               // In floats; grown geometrically when particles are added
+    float m_tearStretch;                // Applied to cloth bodies created later (e.g. by Reset)
+
+    // Incident springs and triangles of every particle for gatherForces (CSR: the elements of
+    // particle i are [offsets[i], offsets[i + 1])). Rebuilt before a step after any topology change.
+    std::vector<unsigned int> m_springOffsets, m_particleSprings;
+    std::vector<unsigned int> m_triangleOffsets, m_particleTriangles;
+    bool m_adjacencyDirty;
+
+    // Per-axis map from a fine grid line to the twin's segment [cell, cell + 1] around it
+    struct LodAxis {
+        std::vector<unsigned int> lines; // Fine grid lines kept by the twin
+        std::vector<unsigned int> cell;  // Per fine line
+        std::vector<float> t;            // Per fine line, 0 at lines[cell], 1 at lines[cell + 1]
+    };
+    // A flag and its coarse twins; level 0 simulates the flag itself, level k twin[k - 1]
+    struct LodRecord {
+        unsigned int fine;
+        unsigned int twins[2];
+        LodAxis columns[2], rows[2];
+        int level;
+        bool torn; // Its topology no longer matches the twins: pinned to level 0
+    };
+    std::vector<LodRecord> m_lods;
+
+    // One midpoint insertion: edge a-b became a-m-b and each adjacent triangle became two
+    struct RemeshSplit {
+        unsigned int body, a, b, m;
+        unsigned int spring;       // Slot of the split edge's spring, now a-m
+        PoolSpring parentSpring;
+        unsigned int newSprings[3]; // m-b, then m to each opposite corner
+        int count;                  // Adjacent triangles (1 on the border, else 2)
+        unsigned int slots[2];      // Slots of the parent triangles, now holding the first halves
+        unsigned int children[2];   // Slots of the second halves
+        PoolTriangle parents[2];
+        PoolTriangle halves[2][2];  // As written, to tell whether a later split changed them
+        float massA, massB;         // Moved from a and b to m
+    };
+    struct EdgeFaces {
+        unsigned int faces[2];
+        int count;
+    };
+    std::vector<RemeshSplit> m_splits;
+    std::vector<unsigned char> m_midpoints; // Per particle: inserted by a split (skips self-collision)
+    std::vector<float> m_restAreas;         // Per particle: rest area of its triangles, during Remesh
+    std::vector<glm::vec2> m_stiffness;     // Per particle: summed ks and kd of its springs, during Remesh
+    std::unordered_map<unsigned long long, unsigned int> m_edgeSprings; // Scratch for Remesh
+    std::unordered_map<unsigned long long, EdgeFaces> m_edgeFaces;
+    std::vector<std::pair<float, unsigned long long>> m_remeshCandidates;
+    int m_stepsSinceRemesh;
+
+    // Free lists and the triangle slots whose EBO entries must be re-uploaded
+    std::vector<unsigned int> m_freeParticles;
+    std::vector<unsigned int> m_freeSprings;
+    std::vector<unsigned int> m_freeTriangles;
+    std::vector<unsigned int> m_dirtyTriangles;
+    std::vector<unsigned int> m_tornSprings;
+
+    unsigned int BeginBody(BodyType type);
+    void EndBody(unsigned int body);
+    unsigned int AddParticle(glm::vec3 position, float mass);
+    void AddSpring(unsigned int p1, unsigned int p2, float ks, float kd, float restLength);
+    void BuildGrid(glm::vec3 origin, int width, int height, float spacing, float totalMass);
+    void BuildCrate(glm::vec3 center, float size, float mass);
+    void BuildRopes(unsigned int canopy, unsigned int crate, int gridW, int gridH);
+
+    // Runtime slot management (builders append instead, so bodies stay contiguous)
+    unsigned int AllocateParticle(const Particle& p, unsigned int body);
+    unsigned int AllocateSpring(const PoolSpring& s);
+    unsigned int AllocateTriangle(const PoolTriangle& t);
+    void ReleaseParticle(unsigned int i);
+    void ReleaseSpring(unsigned int i);
+    void ReleaseTriangle(unsigned int i);
+    void SetTriangle(unsigned int i, const PoolTriangle& t);
+
+    void BuildAdjacency();
+    void GatherForces(const glm::vec3& gravity, const glm::vec3& windVelocity, float airDensity);
+
+    void BuildLodTwins(unsigned int flag);
+    void SetLodLevel(LodRecord& lod, int level);
+    void ReconstructFromTwin(const LodRecord& lod);
+
+    bool RemeshEligible(const WorldBody& b) const;
+    void Remesh(float deltaTime);
+    bool SplitEdge(unsigned int spring, const EdgeFaces& faces, float deltaTime);
+    void UndoSplit(const RemeshSplit& split);
+    bool SplitIntact(const RemeshSplit& split) const;
+    float SplitFold(const RemeshSplit& split) const;
+    float RestArea(const PoolTriangle& t) const;
+
+    void TearSprings();
+    void SplitParticle(unsigned int a, unsigned int b);
+
+    void SetupMesh();
+    void UpdateMesh();
+};
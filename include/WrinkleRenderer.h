@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+class Cloth;
+
+// Draws a Cloth on a finer mesh than it is simulated on. Every grid cell of the cloth is
+// split into subdivisions x subdivisions quads placed on a Catmull-Rom patch through the
+// particles, then displaced along the normal where the structural springs are compressed:
+// a sheet that can't shorten folds instead, and a sine of wavelength w takes up a
+// compression c with amplitude w sqrt(c) / pi. Simulation resolution stays the cloth's
+// own width x height; only the render mesh follows subdivisions.
+// Uses the 6-float layout of Shader/cloth.vert.
+class WrinkleRenderer {
+public:
+    int subdivisions;        // Render quads per simulated cell along each axis (1 = none)
+    float wrinkleAmplitude;  // Scale on the compression-implied amplitude (0 = smooth only)
+    float wrinkleWavelength; // In render vertices (>= 2)
+
+    std::vector<float> vertexData;     // PosX, PosY, PosZ, NormX, NormY, NormZ per render vertex
+    std::vector<unsigned int> indices; // Same winding as Cloth::indices
+    unsigned int VAO, VBO, EBO;        // Created on the first Draw
+
+    WrinkleRenderer();
+    ~WrinkleRenderer();
+
+    // Rebuilds the render mesh from the cloth's current particles (no GL calls)
+    void Update(const Cloth& cloth);
+    void Draw(unsigned int shaderProgram); // Draws the last Update
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+
+private:
+    int m_width, m_height;                 // Render grid, (cloth - 1) * subdivisions + 1
+    std::vector<glm::vec3> m_positions;    // Undisplaced, then displaced
+    std::vector<glm::vec3> m_normals;
+    std::vector<glm::vec2> m_compression;  // Per cloth particle, along grid x and y
+    bool m_meshDirty;                      // Render grid changed: buffers re-specified on the next Draw
+
+    void BuildIndices();
+    void ComputeNormals();
+    void SetupMesh();
+};
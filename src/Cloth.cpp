@@ -4,15 +4,30 @@
 #include <algorithm> // For std::sort
 
 Cloth::Cloth(int width, int height, float spacing, float totalMass) {
+    colliders = ColliderSet::Ground();
+    windField = nullptr;
+    gpuNormals = false;
+    interpolate = false;
+    quantizedVertices = false;
+    VAO = 0;
+
+    // up, down, right and left neighbor particle
+    structural.springConstant = 450.0f; structural.dampingFactor = 0.5f;
+    // diagonal particles
+    shear.springConstant      = 100.0f; shear.dampingFactor      = 0.5f;
+    // up, down, right and left one particle
+    bend.springConstant       = 200.0f; bend.dampingFactor       = 0.5f;
+    dragCoefficient = 1.5f; // Fabric drag coefficient
+    kRepel = 2000.0f;       // Stiff repulsion spring
+    projectiveDynamics = false;
+    m_pdWeights[0] = m_pdWeights[1] = m_pdWeights[2] = -1.0f; // Springs built on first use
+
     InitCloth(width, height, spacing, totalMass);
-    SetupMesh(); 
 }
 
 Cloth::~Cloth() {
     // Clean up dynamically allocated memory
     for (auto p : particles) delete p;
-    for (auto s : springs) delete s;
-    for (auto t : triangles) delete t;
 }
 
 void Cloth::InitCloth(int width, int height, float spacing, float totalMass) {
@@ -21,13 +36,6 @@ void Cloth::InitCloth(int width, int height, float spacing, float totalMass) {
     m_spacing = spacing;
     m_totalMass = totalMass;
 
-    // up, down, right and left neighbor particle
-    float ksStruct = 450.0f, kdStruct = 0.5f;
-    // diagonal particles
-    float ksShear  = 100.0f, kdShear  = 0.5f;
-    // up, down, right and left one particle
-    float ksBend   = 200.0f, kdBend   = 0.5f;
-
     float particleMass = totalMass / (width * height);
 
     // 1. GENERATE PARTICLES
@@ -50,29 +58,12 @@ void Cloth::InitCloth(int width, int height, float spacing, float totalMass) {
             particles.push_back(p);
         }
     }
-    auto GetParticle = [&](int x, int y) -> Particle* {
-        return particles[y * width + x];
-    };
-    // 2. GENERATE SPRINGS
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            Particle* p = GetParticle(x, y);
-            // Generate Structural Springs
-            if (x < width - 1) springs.push_back(new SpringDamper(p, GetParticle(x + 1, y), ksStruct, kdStruct, spacing));
-            if (y < height - 1) springs.push_back(new SpringDamper(p, GetParticle(x, y + 1), ksStruct, kdStruct, spacing));
-            
-            // Generate Shear Springs
-            float shearDist = glm::root_two<float>() * spacing;
-            if (x < width - 1 && y < height - 1) {
-                springs.push_back(new SpringDamper(p, GetParticle(x + 1, y + 1), ksShear, kdShear, shearDist));
-                springs.push_back(new SpringDamper(GetParticle(x + 1, y), GetParticle(x, y + 1), ksShear, kdShear, shearDist));
-            }
-            // Generate Bending Springs
-            if (x < width - 2) springs.push_back(new SpringDamper(p, GetParticle(x + 2, y), ksBend, kdBend, spacing * 2.0f));
-            if (y < height - 2) springs.push_back(new SpringDamper(p, GetParticle(x, y + 2), ksBend, kdBend, spacing * 2.0f));
-        }
-    }
-    // 3. GENERATE TRIANGLES AND OPENGL INDICES
+    // 2. SPRING FAMILIES (the pairs are implied by the grid, only the rest lengths depend on it)
+    structural.restLength = spacing;
+    shear.restLength = glm::root_two<float>() * spacing;
+    bend.restLength = spacing * 2.0f;
+
+    // 3. GENERATE TRIANGLE INDICES (rendering, drag and normals all run over them)
     for (int y = 0; y < height - 1; ++y) {
         for (int x = 0; x < width - 1; ++x) {
             // vertices position
@@ -80,20 +71,13 @@ void Cloth::InitCloth(int width, int height, float spacing, float totalMass) {
             int topRightIdx    = y * width + (x + 1);
             int bottomLeftIdx  = (y + 1) * width + x;
             int bottomRightIdx = (y + 1) * width + (x + 1);
-            
-            Particle* pTL = particles[topLeftIdx];
-            Particle* pTR = particles[topRightIdx];
-            Particle* pBL = particles[bottomLeftIdx];
-            Particle* pBR = particles[bottomRightIdx];
-        
+
             // Triangle 1
-            triangles.push_back(new Triangle(pTL, pBL, pTR));
             indices.push_back(topLeftIdx);
             indices.push_back(bottomLeftIdx);
             indices.push_back(topRightIdx);
 
             // Triangle 2
-            triangles.push_back(new Triangle(pTR, pBL, pBR));
             indices.push_back(topRightIdx);
             indices.push_back(bottomLeftIdx);
             indices.push_back(bottomRightIdx);
@@ -106,30 +90,26 @@ void Cloth::InitCloth(int width, int height, float spacing, float totalMass) {
 void Cloth::UpdatePhysics(float deltaTime, const glm::vec3& windVelocity) {
     glm::vec3 gravity(0.0f, -9.81f, 0.0f);
     float airDensity = 1.225f; // Standard air density
-    float dragCoefficient = 1.5f; // Fabric drag coefficient
 
-    // 1. Reset normals and forces
+    // 1. Reset normals and forces (and sum the particle energies on the way)
+    diagnostics.Clear();
     for (Particle* p : particles) {
-        p->normal = glm::vec3(0.0f);
+        if (!gpuNormals) p->normal = glm::vec3(0.0f);
         p->ClearForces();
         p->ApplyForce(gravity * p->mass); // Apply Gravity
+        diagnostics.AddParticle(*p, -gravity.y);
     }
 
-    // 2. Compute Spring Forces
-    for (SpringDamper* sd : springs) {
-        sd->ComputeForce();
-    }
+    // 2. Compute Spring Forces (projective dynamics solves the springs implicitly in step 4)
+    if (!projectiveDynamics) ComputeSpringForces(&diagnostics);
 
-    // 3. Compute Triangles (Normals and Aerodynamics)
-    for (Triangle* t : triangles) {
-        t->ComputeNormal();
-        t->ComputeAerodynamicForce(windVelocity, airDensity, dragCoefficient);
-    }
+    // 3. Compute Triangles (Normals and Aerodynamics) in one fused pass over the index buffer
+    Triangle::ComputeNormalsAndAerodynamics(particles.data(), indices.data(), indices.size() / 3,
+                                            windVelocity, airDensity, dragCoefficient, windField, !gpuNormals);
 
     // 3.5 Compute Self-Collision
     // Optimized with 1D Sweep and Prune (Sorting along the X axis) to avoid O(N^2) checks.
     float selfCollisionPoints = 0.3f; // Thickness threshold before repulsion
-    float kRepel = 2000.0f;           // Stiff repulsion spring
     
     // Create a sorted array of particles along the X axis
     thread_local std::vector<Particle*> sortedParticles;
@@ -174,34 +154,32 @@ void Cloth::UpdatePhysics(float deltaTime, const glm::vec3& windVelocity) {
         }
     }
 
-    // 4. Normalize Vertices, Integrate, and Handle Ground Collision
-    float groundY = -10.0f; // The height of your ground plane
-    float groundRestitution = 0.2f; // How bouncy the ground is
-    float groundFriction = 0.8f; // How much it slides (0.0 = ice, 1.0 = sticks completely)
-
+    // 4. Normalize Vertices and Integrate
 
     for (Particle* p : particles) {
-        // Prepare normals for rendering
-        if (glm::length(p->normal) > 0.0f) {
-            p->normal = glm::normalize(p->normal);
-        } else {
-            p->normal = glm::vec3(0.0f, 1.0f, 0.0f); // Fallback
+        // Prepare normals for rendering (the GPU path derives them in the vertex shader)
+        if (!gpuNormals) {
+            if (glm::length(p->normal) > 0.0f) {
+                p->normal = glm::normalize(p->normal);
+            } else {
+                p->normal = glm::vec3(0.0f, 1.0f, 0.0f); // Fallback
+            }
         }
 
         // Integrate (Update position/velocity)
-        p->Update(deltaTime);
-
-        // Ground Plane Collision handling (Added cloth thickness to avoid Z-fighting)
-        float clothThickness = 0.05f;
-        if (p->position.y < groundY + clothThickness) { // have to check it one more time
-            p->position.y = groundY + clothThickness;
-            
-            // Reflect velocity and apply damping/friction
-            p->velocity.y = -p->velocity.y * groundRestitution;
-            p->velocity.x *= (1.0f - groundFriction);
-            p->velocity.z *= (1.0f - groundFriction);
-        } 
+        if (!projectiveDynamics) p->Update(deltaTime);
     }
+    if (projectiveDynamics) {
+        SyncProjectiveSprings();
+        pdSolver.Step(particles.data(), particles.size(), deltaTime, &diagnostics);
+    }
+
+    // 5. Collide with the ground and any obstacles in one batch
+    // (Added cloth thickness to avoid Z-fighting)
+    float clothThickness = 0.05f;
+    float groundRestitution = 0.2f; // How bouncy the ground is
+    float groundFriction = 0.8f; // How much it slides (0.0 = ice, 1.0 = sticks completely)
+    colliders.ResolveParticles(particles.data(), particles.size(), clothThickness, groundRestitution, groundFriction);
 }
 
 void Cloth::SetupMesh() {
@@ -212,21 +190,119 @@ void Cloth::SetupMesh() {
     glBindVertexArray(VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // Position (Location 0) and normal (Location 1), floats or packed; the VBO fits either
+    SetVertexAttributes(quantizedVertices);
+    vaoPacked = quantizedVertices;
+
+    // Previous tick positions (Location 2), seeded with the current ones
+    if (previousPositions.size() != particles.size()) StorePreviousPositions();
+    glGenBuffers(1, &previousVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+    glBufferData(GL_ARRAY_BUFFER, previousPositions.size() * sizeof(glm::vec3), previousPositions.data(), GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(2);
     
     glBindVertexArray(0);
+
+    SetupAdjacency();
+}
+
+void Cloth::SetupAdjacency() {
+    // 1. CSR adjacency: for every vertex, the other two corners of each incident triangle,
+    // rotated so cross(b - v, c - v) keeps the triangle's winding
+    std::vector<int> offsets(particles.size() + 1, 0);
+    for (unsigned int idx : indices) offsets[idx + 1] += 2;
+    for (size_t i = 0; i < particles.size(); i++) offsets[i + 1] += offsets[i];
+
+    std::vector<int> adjacency(offsets.back());
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = indices[t + k];
+            adjacency[cursor[v]++] = indices[t + (k + 1) % 3];
+            adjacency[cursor[v]++] = indices[t + (k + 2) % 3];
+        }
+    }
+
+    // 2. Positions-only vertex buffer, bound both as attribute 0 and as a float texture buffer
+    positionData.resize(particles.size() * 3);
+    glGenVertexArrays(1, &positionVAO);
+    glGenBuffers(1, &positionVBO);
+    glBindVertexArray(positionVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, positionVBO);
+    glBufferData(GL_ARRAY_BUFFER, positionData.size() * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+
+    glGenTextures(1, &positionTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, positionTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, positionVBO);
+
+    // 3. Static adjacency buffers
+    glGenBuffers(1, &adjacencyOffsetBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, adjacencyOffsetBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, offsets.size() * sizeof(int), offsets.data(), GL_STATIC_DRAW);
+    glGenTextures(1, &adjacencyOffsetTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, adjacencyOffsetTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, adjacencyOffsetBuffer);
+
+    glGenBuffers(1, &adjacencyBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, adjacencyBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, adjacency.size() * sizeof(int), adjacency.data(), GL_STATIC_DRAW);
+    glGenTextures(1, &adjacencyTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, adjacencyTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, adjacencyBuffer);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void Cloth::StorePreviousPositions() {
+    previousPositions.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); i++) {
+        previousPositions[i] = particles[i]->position;
+    }
 }
 
 void Cloth::UpdateMesh() {
+    if (interpolate) {
+        glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, previousPositions.size() * sizeof(glm::vec3), previousPositions.data());
+    }
+
+    if (gpuNormals) {
+        // Half the upload: the vertex shader rebuilds the normals
+        int index = 0;
+        for (Particle* p : particles) {
+            positionData[index++] = p->position.x;
+            positionData[index++] = p->position.y;
+            positionData[index++] = p->position.z;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, positionVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, positionData.size() * sizeof(float), positionData.data());
+        return;
+    }
+
+    if (quantizedVertices) {
+        // A third of the upload: 16-bit positions in this frame's bounds and 8-bit normals
+        packedData.resize(particles.size());
+        packedBounds = ComputePackedBounds(particles.data(), particles.size());
+        PackVertices(particles.data(), particles.size(), packedBounds, packedData.data());
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, packedData.size() * sizeof(PackedVertex), packedData.data());
+        return;
+    }
+
     int index = 0;
     for (Particle* p : particles) {
         vertexData[index++] = p->position.x;
@@ -243,30 +319,166 @@ void Cloth::UpdateMesh() {
 
 void Cloth::Draw(unsigned int shaderProgram) {
     glUseProgram(shaderProgram);
+    if (!VAO) SetupMesh();
+    if (quantizedVertices != vaoPacked) {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        SetVertexAttributes(quantizedVertices);
+        glBindVertexArray(0);
+        vaoPacked = quantizedVertices;
+    }
 
     UpdateMesh();
 
+    if (gpuNormals) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_BUFFER, positionTexture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_BUFFER, adjacencyOffsetTexture);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_BUFFER, adjacencyTexture);
+        glActiveTexture(GL_TEXTURE0);
+        glUniform1i(glGetUniformLocation(shaderProgram, "positions"), 0);
+        glUniform1i(glGetUniformLocation(shaderProgram, "adjacencyOffsets"), 1);
+        glUniform1i(glGetUniformLocation(shaderProgram, "adjacency"), 2);
+
+        glBindVertexArray(positionVAO);
+        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+        return;
+    }
+
+    if (quantizedVertices) SetPackedBoundsUniforms(shaderProgram, packedBounds);
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0); 
     glBindVertexArray(0);
 }
 
+void Cloth::DeleteMesh() {
+    if (!VAO) return;
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &previousVBO);
+
+    glDeleteVertexArrays(1, &positionVAO);
+    glDeleteBuffers(1, &positionVBO);
+    glDeleteTextures(1, &positionTexture);
+    glDeleteBuffers(1, &adjacencyOffsetBuffer);
+    glDeleteTextures(1, &adjacencyOffsetTexture);
+    glDeleteBuffers(1, &adjacencyBuffer);
+    glDeleteTextures(1, &adjacencyTexture);
+    VAO = 0;
+}
+
+void Cloth::SetSpringConstants(float structural, float shear, float bend) {
+    this->structural.springConstant = structural;
+    this->shear.springConstant = shear;
+    this->bend.springConstant = bend;
+}
+
+void Cloth::ScaleStiffness(float springScale, float dampingScale) {
+    for (SpringFamily* family : { &structural, &shear, &bend }) {
+        family->springConstant *= springScale;
+        family->dampingFactor *= dampingScale;
+    }
+}
+
+template <int DX, int DY, typename Visit>
+void Cloth::ForEachSpring(Visit visit) const {
+    const int xBegin = DX < 0 ? -DX : 0;
+    const int xEnd = DX > 0 ? m_width - DX : m_width;
+    const int offset = DY * m_width + DX;
+    for (int y = 0; y < m_height - DY; y++) {
+        Particle* const* row = &particles[y * m_width];
+        for (int x = xBegin; x < xEnd; x++) {
+            visit(*row[x], *row[x + offset]);
+        }
+    }
+}
+
+void Cloth::ComputeSpringForces(SimDiagnostics* diagnostics) {
+    // SpringDamper::ComputeForce with the family's constants hoisted out of the loop.
+    // Energies go to a local copy so the loop doesn't write through the pointer.
+    SimDiagnostics springs;
+    auto springForce = [&springs](const SpringFamily& family) {
+        float ks = family.springConstant, kd = family.dampingFactor, rest = family.restLength;
+        return [&springs, ks, kd, rest](Particle& a, Particle& b) {
+            glm::vec3 e = b.position - a.position;
+            float l = glm::length(e);
+            if (l == 0.0f) return;
+            glm::vec3 e_hat = e / l;
+            float v_rel_1D = glm::dot(b.velocity - a.velocity, e_hat);
+            glm::vec3 f_total = (ks * (l - rest) + kd * v_rel_1D) * e_hat;
+            a.forceAccumulator += f_total;
+            b.forceAccumulator -= f_total;
+            springs.AddSpring(ks, l - rest, rest);
+        };
+    };
+    ForEachSpring<1, 0>(springForce(structural));
+    ForEachSpring<0, 1>(springForce(structural));
+    ForEachSpring<1, 1>(springForce(shear));
+    ForEachSpring<-1, 1>(springForce(shear));
+    ForEachSpring<2, 0>(springForce(bend));
+    ForEachSpring<0, 2>(springForce(bend));
+    if (diagnostics) diagnostics->Add(springs);
+}
+
+void Cloth::SyncProjectiveSprings() {
+    const SpringFamily* families[3] = { &structural, &shear, &bend };
+    bool changed = false;
+    for (int f = 0; f < 3; f++) changed |= m_pdWeights[f] != families[f]->springConstant;
+    if (!changed) return;
+
+    // Same pairs as ForEachSpring, by particle index
+    std::vector<ProjectiveDynamics::Spring> springs;
+    auto addFamily = [&](int dx, int dy, const SpringFamily& family) {
+        for (int y = 0; y + dy < m_height; y++) {
+            for (int x = std::max(0, -dx); x < m_width - std::max(0, dx); x++) {
+                unsigned int a = y * m_width + x;
+                unsigned int b = (y + dy) * m_width + x + dx;
+                springs.push_back({ a, b, family.springConstant, family.restLength });
+            }
+        }
+    };
+    addFamily(1, 0, structural);
+    addFamily(0, 1, structural);
+    addFamily(1, 1, shear);
+    addFamily(-1, 1, shear);
+    addFamily(2, 0, bend);
+    addFamily(0, 2, bend);
+    pdSolver.SetSprings(springs);
+    pdSolver.SetGrid(m_width, m_height);
+    for (int f = 0; f < 3; f++) m_pdWeights[f] = families[f]->springConstant;
+}
+
+float Cloth::MaxStretch() const {
+    float maxStretch = 0.0f;
+    auto stretch = [&maxStretch](const SpringFamily& family) {
+        float invRest = 1.0f / family.restLength;
+        return [&maxStretch, invRest](const Particle& a, const Particle& b) {
+            maxStretch = std::max(maxStretch, glm::length(b.position - a.position) * invRest);
+        };
+    };
+    ForEachSpring<1, 0>(stretch(structural));
+    ForEachSpring<0, 1>(stretch(structural));
+    ForEachSpring<1, 1>(stretch(shear));
+    ForEachSpring<-1, 1>(stretch(shear));
+    ForEachSpring<2, 0>(stretch(bend));
+    ForEachSpring<0, 2>(stretch(bend));
+    return maxStretch;
+}
+
 void Cloth::Reset() {
     // Clean up old data
     for (auto p : particles) delete p;
-    for (auto s : springs) delete s;
-    for (auto t : triangles) delete t;
     particles.clear();
-    springs.clear();
-    triangles.clear();
     indices.clear();
     vertexData.clear();
+    positionData.clear();
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    DeleteMesh();
 
-    // Re-initialize
+    // Re-initialize (the GL buffers are rebuilt on the next Draw)
     InitCloth(m_width, m_height, m_spacing, m_totalMass);
-    SetupMesh();
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "ClothTile.h"
+#include "GridClothKernel.h"
+
+ClothTile::ClothTile(int x0, int y0, int x1, int y1, float spacing, float particleMass) {
+    this->x0 = x0;
+    this->y0 = y0;
+    this->x1 = x1;
+    this->y1 = y1;
+    this->spacing = spacing;
+    this->particleMass = particleMass;
+
+    GridSpringFamilies(spacing, structural, shear, bend);
+    dragCoefficient = kGridDragCoefficient;
+    airDensity = kGridAirDensity;
+    colliders = ColliderSet::Ground();
+}
+
+void ClothTile::InitGrid(ClothGridState& state, float spacing) {
+    for (int y = 0; y < state.height; ++y) {
+        for (int x = 0; x < state.width; ++x) {
+            size_t i = state.Index(x, y);
+            state.positions[0][i] = GridRestPosition(x, y, state.width, spacing);
+            state.velocities[0][i] = glm::vec3(0.0f);
+        }
+    }
+}
+
+void ClothTile::Step(const ClothGridState& state, int read, float deltaTime, const glm::vec3& windVelocity) {
+    const glm::vec3* positions = state.positions[read];
+    const glm::vec3* velocities = state.velocities[read];
+    glm::vec3* outPositions = state.positions[1 - read];
+    glm::vec3* outVelocities = state.velocities[1 - read];
+
+    glm::vec3 gravity(0.0f, -9.81f, 0.0f);
+    float dragScale = airDensity * dragCoefficient / 12.0f; // See Triangle::ComputeNormalAndAerodynamicForce
+
+    const SpringFamily* families[3] = { &structural, &shear, &bend };
+
+    int rowLength = x1 - x0;
+    m_row.assign(rowLength, Particle(glm::vec3(0.0f), particleMass));
+    m_points.resize(rowLength);
+    m_distances.resize(rowLength);
+    m_normals.resize(rowLength);
+
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            size_t i = state.Index(x, y);
+            Particle& p = m_row[x - x0];
+            p.position = positions[i];
+            p.velocity = velocities[i];
+            p.isFixed = (y == 0); // InitCloth pins the top row
+            p.ClearForces();
+            p.ApplyForce(gravity * p.mass);
+
+            // 1. Springs: both directions of every stencil entry, in a fixed order
+            for (const GridSpringDirection& d : kGridSprings) {
+                const SpringFamily& family = *families[d.family];
+                for (int sign = 1; sign >= -1; sign -= 2) {
+                    int nx = x + sign * d.dx, ny = y + sign * d.dy;
+                    if (nx < 0 || ny < 0 || nx >= state.width || ny >= state.height) continue;
+                    size_t j = state.Index(nx, ny);
+                    float l;
+                    glm::vec3 e = positions[j] - p.position;
+                    p.ApplyForce(GridSpringForceScale(e, velocities[j] - p.velocity, family.springConstant,
+                                                      family.dampingFactor, family.restLength, l) * e);
+                }
+            }
+
+            // 2. Drag of the (up to 6) triangles around the particle
+            for (int cy = y - 1; cy <= y; cy++) {
+                for (int cx = x - 1; cx <= x; cx++) {
+                    if (cx < 0 || cy < 0 || cx >= state.width - 1 || cy >= state.height - 1) continue;
+                    size_t faces[2][3];
+                    GridCellFaces(state.Index(cx, cy), state.width, faces);
+                    for (const size_t* f : faces) {
+                        if (f[0] != i && f[1] != i && f[2] != i) continue;
+                        glm::vec3 crossProduct;
+                        p.ApplyForce(GridFaceDrag(positions[f[0]], positions[f[1]], positions[f[2]],
+                                                  velocities[f[0]] + velocities[f[1]] + velocities[f[2]],
+                                                  windVelocity, dragScale, crossProduct));
+                    }
+                }
+            }
+
+            // 3. Integrate
+            p.Update(deltaTime);
+            m_points[x - x0] = p.position;
+        }
+
+        // 4. Ground and obstacles for the whole row in one batch (same response as Cloth)
+        colliders.Query(m_points.data(), rowLength, m_distances.data(), m_normals.data());
+        for (int x = x0; x < x1; x++) {
+            Particle& p = m_row[x - x0];
+            if (m_distances[x - x0] < kGridColliderThickness && !p.isFixed) {
+                ColliderSet::Respond(p, m_distances[x - x0], m_normals[x - x0], kGridColliderThickness,
+                                     kGridColliderRestitution, kGridColliderFriction);
+            }
+            size_t i = state.Index(x, y);
+            outPositions[i] = p.position;
+            outVelocities[i] = p.velocity;
+        }
+    }
+}
@@ -0,0 +1,289 @@
+#include "Collider.h"
+#include "Particle.h"
+#include "ParallelFor.h"
+#include <glm/gtc/constants.hpp>
+#include <cfloat>
+#include <iostream>
+
+SignedDistanceField::SignedDistanceField() {
+    resolution = glm::ivec3(0);
+    origin = glm::vec3(0.0f);
+    cellSize = 1.0f;
+}
+
+// Closest point on triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5)
+static glm::vec3 ClosestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Solid angle of triangle abc seen from p (Van Oosterom and Strackee)
+static float SolidAngle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 ra = a - p, rb = b - p, rc = c - p;
+    float la = glm::length(ra), lb = glm::length(rb), lc = glm::length(rc);
+    float numerator = glm::dot(ra, glm::cross(rb, rc));
+    float denominator = la * lb * lc + glm::dot(ra, rb) * lc + glm::dot(ra, rc) * lb + glm::dot(rb, rc) * la;
+    return 2.0f * atan2(numerator, denominator);
+}
+
+SignedDistanceField SignedDistanceField::FromMesh(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices, float cellSize, float padding) {
+    SignedDistanceField sdf;
+    glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+    for (const glm::vec3& v : vertices) {
+        boundsMin = glm::min(boundsMin, v);
+        boundsMax = glm::max(boundsMax, v);
+    }
+    if (vertices.empty() || !(cellSize > 0.0f)) {
+        std::cout << "ERROR::SDF::EMPTY_MESH_OR_BAD_CELL_SIZE" << std::endl;
+        return sdf;
+    }
+    boundsMin -= glm::vec3(padding);
+    boundsMax += glm::vec3(padding);
+
+    // At least two samples per axis (a flat mesh without padding spans one), as Sample
+    // interpolates between neighbours
+    sdf.cellSize = cellSize;
+    sdf.origin = boundsMin;
+    sdf.resolution = glm::max(glm::ivec3(glm::ceil((boundsMax - boundsMin) / cellSize)) + glm::ivec3(1), glm::ivec3(2));
+    sdf.distances.resize((size_t)sdf.resolution.x * sdf.resolution.y * sdf.resolution.z);
+
+    // Every z slice is independent, so slices are split across threads
+    ParallelFor(0, sdf.resolution.z, [&](size_t zBegin, size_t zEnd) {
+        for (int z = (int)zBegin; z < (int)zEnd; z++) {
+            for (int y = 0; y < sdf.resolution.y; y++) {
+                for (int x = 0; x < sdf.resolution.x; x++) {
+                    glm::vec3 p = sdf.origin + glm::vec3(x, y, z) * cellSize;
+                    float closest2 = FLT_MAX;
+                    float winding = 0.0f;
+                    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+                        const glm::vec3& a = vertices[indices[t]];
+                        const glm::vec3& b = vertices[indices[t + 1]];
+                        const glm::vec3& c = vertices[indices[t + 2]];
+                        glm::vec3 d = p - ClosestPointOnTriangle(p, a, b, c);
+                        closest2 = glm::min(closest2, glm::dot(d, d));
+                        winding += SolidAngle(p, a, b, c);
+                    }
+                    bool inside = winding / (4.0f * glm::pi<float>()) > 0.5f;
+                    float distance = sqrt(closest2);
+                    sdf.distances[((size_t)z * sdf.resolution.y + y) * sdf.resolution.x + x] = inside ? -distance : distance;
+                }
+            }
+        }
+    });
+    return sdf;
+}
+
+float SignedDistanceField::Sample(const glm::vec3& p) const {
+    // An empty (default-constructed or rejected) field has no surface anywhere
+    if (!IsValid()) return FLT_MAX;
+
+    // 1. Clamp into the grid and remember how far outside we were
+    glm::vec3 gridMax = origin + glm::vec3(resolution - glm::ivec3(1)) * cellSize;
+    glm::vec3 clamped = glm::clamp(p, origin, gridMax);
+    float outside = glm::length(p - clamped);
+
+    // 2. Trilinear interpolation of the 8 surrounding samples
+    glm::vec3 g = (clamped - origin) / cellSize;
+    glm::ivec3 i0 = glm::min(glm::ivec3(g), resolution - glm::ivec3(2));
+    glm::vec3 f = g - glm::vec3(i0);
+
+    float c00 = glm::mix(At(i0.x, i0.y,     i0.z),     At(i0.x + 1, i0.y,     i0.z),     f.x);
+    float c10 = glm::mix(At(i0.x, i0.y + 1, i0.z),     At(i0.x + 1, i0.y + 1, i0.z),     f.x);
+    float c01 = glm::mix(At(i0.x, i0.y,     i0.z + 1), At(i0.x + 1, i0.y,     i0.z + 1), f.x);
+    float c11 = glm::mix(At(i0.x, i0.y + 1, i0.z + 1), At(i0.x + 1, i0.y + 1, i0.z + 1), f.x);
+    float c0 = glm::mix(c00, c10, f.y);
+    float c1 = glm::mix(c01, c11, f.y);
+    return glm::mix(c0, c1, f.z) + outside;
+}
+
+glm::vec3 SignedDistanceField::Gradient(const glm::vec3& p) const {
+    if (!IsValid()) return glm::vec3(0.0f, 1.0f, 0.0f);
+    // Central differences of the trilinear field
+    float h = cellSize * 0.5f;
+    glm::vec3 g(
+        Sample(p + glm::vec3(h, 0, 0)) - Sample(p - glm::vec3(h, 0, 0)),
+        Sample(p + glm::vec3(0, h, 0)) - Sample(p - glm::vec3(0, h, 0)),
+        Sample(p + glm::vec3(0, 0, h)) - Sample(p - glm::vec3(0, 0, h))
+    );
+    float l = glm::length(g);
+    return l > 0.0f ? g / l : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+void ColliderSet::AddPlane(const glm::vec3& point, const glm::vec3& normal) {
+    Collider c = {};
+    c.type = ColliderType::Plane;
+    c.a = point;
+    c.b = glm::normalize(normal);
+    colliders.push_back(c);
+}
+
+void ColliderSet::AddSphere(const glm::vec3& center, float radius) {
+    Collider c = {};
+    c.type = ColliderType::Sphere;
+    c.a = center;
+    c.radius = radius;
+    colliders.push_back(c);
+}
+
+void ColliderSet::AddCapsule(const glm::vec3& start, const glm::vec3& end, float radius) {
+    Collider c = {};
+    c.type = ColliderType::Capsule;
+    c.a = start;
+    c.b = end;
+    c.radius = radius;
+    colliders.push_back(c);
+}
+
+void ColliderSet::AddBox(const glm::vec3& center, const glm::vec3& halfExtents, const glm::mat3& rotation) {
+    Collider c = {};
+    c.type = ColliderType::Box;
+    c.a = center;
+    c.halfExtents = halfExtents;
+    c.rotation = rotation;
+    colliders.push_back(c);
+}
+
+void ColliderSet::AddField(const SignedDistanceField* field, const glm::vec3& offset) {
+    if (!field || !field->IsValid()) {
+        std::cout << "ERROR::COLLIDER::INVALID_FIELD" << std::endl;
+        return;
+    }
+    Collider c = {};
+    c.type = ColliderType::Field;
+    c.a = offset;
+    c.field = field;
+    colliders.push_back(c);
+}
+
+void ColliderSet::Query(const glm::vec3* points, size_t count, float* distances, glm::vec3* normals) const {
+    for (size_t i = 0; i < count; i++) {
+        distances[i] = FLT_MAX;
+        normals[i] = glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+
+    for (const Collider& c : colliders) {
+        switch (c.type) {
+        case ColliderType::Plane:
+            for (size_t i = 0; i < count; i++) {
+                float d = glm::dot(points[i] - c.a, c.b);
+                if (d < distances[i]) { distances[i] = d; normals[i] = c.b; }
+            }
+            break;
+
+        case ColliderType::Sphere:
+            for (size_t i = 0; i < count; i++) {
+                glm::vec3 v = points[i] - c.a;
+                float l = glm::length(v);
+                float d = l - c.radius;
+                if (d < distances[i]) { distances[i] = d; normals[i] = l > 0.0f ? v / l : glm::vec3(0, 1, 0); }
+            }
+            break;
+
+        case ColliderType::Capsule: {
+            glm::vec3 axis = c.b - c.a;
+            float invAxisLength2 = 1.0f / glm::max(glm::dot(axis, axis), 1e-12f);
+            for (size_t i = 0; i < count; i++) {
+                float t = glm::clamp(glm::dot(points[i] - c.a, axis) * invAxisLength2, 0.0f, 1.0f);
+                glm::vec3 v = points[i] - (c.a + axis * t);
+                float l = glm::length(v);
+                float d = l - c.radius;
+                if (d < distances[i]) { distances[i] = d; normals[i] = l > 0.0f ? v / l : glm::vec3(0, 1, 0); }
+            }
+            break;
+        }
+
+        case ColliderType::Box: {
+            glm::mat3 toLocal = glm::transpose(c.rotation);
+            for (size_t i = 0; i < count; i++) {
+                glm::vec3 local = toLocal * (points[i] - c.a);
+                glm::vec3 q = glm::abs(local) - c.halfExtents;
+                glm::vec3 outsideVec = glm::max(q, glm::vec3(0.0f));
+                float outside = glm::length(outsideVec);
+                float inside = glm::min(glm::max(q.x, glm::max(q.y, q.z)), 0.0f);
+                float d = outside + inside;
+                if (d >= distances[i]) continue;
+
+                glm::vec3 localNormal;
+                if (outside > 0.0f) {
+                    localNormal = glm::sign(local) * outsideVec / outside;
+                } else if (q.x >= q.y && q.x >= q.z) {
+                    localNormal = glm::vec3(local.x < 0.0f ? -1.0f : 1.0f, 0, 0);
+                } else if (q.y >= q.z) {
+                    localNormal = glm::vec3(0, local.y < 0.0f ? -1.0f : 1.0f, 0);
+                } else {
+                    localNormal = glm::vec3(0, 0, local.z < 0.0f ? -1.0f : 1.0f);
+                }
+                distances[i] = d;
+                normals[i] = c.rotation * localNormal;
+            }
+            break;
+        }
+
+        case ColliderType::Field:
+            for (size_t i = 0; i < count; i++) {
+                glm::vec3 p = points[i] - c.a;
+                float d = c.field->Sample(p);
+                // Gradients are only needed for points that actually win
+                if (d < distances[i]) { distances[i] = d; normals[i] = c.field->Gradient(p); }
+            }
+            break;
+        }
+    }
+}
+
+void ColliderSet::ResolveParticles(Particle* const* particles, size_t count, float thickness, float restitution, float friction) const {
+    // 1. Gather positions into a contiguous batch
+    m_points.resize(count);
+    m_distances.resize(count);
+    m_normals.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_points[i] = particles[i]->position;
+    }
+
+    // 2. One batched query for all colliders
+    Query(m_points.data(), count, m_distances.data(), m_normals.data());
+
+    // 3. Respond only where a particle is within thickness of a surface
+    for (size_t i = 0; i < count; i++) {
+        if (m_distances[i] < thickness && !particles[i]->isFixed) {
+            Respond(*particles[i], m_distances[i], m_normals[i], thickness, restitution, friction);
+        }
+    }
+}
+
+void ColliderSet::Respond(Particle& p, float distance, const glm::vec3& normal, float thickness, float restitution, float friction) {
+    p.position += normal * (thickness - distance);
+
+    // Reflect velocity and apply damping/friction
+    float vn = glm::dot(p.velocity, normal);
+    glm::vec3 tangential = p.velocity - vn * normal;
+    if (vn < 0.0f) vn = -vn * restitution;
+    p.velocity = vn * normal + tangential * (1.0f - friction);
+}
+
+ColliderSet ColliderSet::Ground(float groundY) {
+    ColliderSet set;
+    set.AddPlane(glm::vec3(0.0f, groundY, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return set;
+}
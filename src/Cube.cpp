@@ -1,10 +1,10 @@
 #include "Cube.h"
 
-Cube::Cube(glm::vec3 center, float size, float mass){
+Cube::Cube(glm::vec3 center, float size, float mass)
+    : body(center, mass, glm::mat3(mass * size * size / 6.0f)) { // Solid cube inertia
     float s = size / 2.0f;
     float pMass = mass / 8.0f;
-    float ks = 5000.0f; // Very stiff for a "solid" feel
-    float kd = 50.0f;   // High damping to prevent jitter
+    halfSize = s;
 
     // 1. Create 8 corners
     // Order: z=0 face first, then z=1 face
@@ -13,21 +13,18 @@ Cube::Cube(glm::vec3 center, float size, float mass){
     for (int z = 0; z < 2; z++) {
         for (int y = 0; y < 2; y++) {
             for (int x = 0; x < 2; x++) {
-                glm::vec3 pos = center + glm::vec3(x ? s : -s, y ? s : -s, z ? s : -s);
-                particles.push_back(new Particle(pos, pMass));
-            }
-        }
-    }
+                glm::vec3 local(x ? s : -s, y ? s : -s, z ? s : -s);
+                body.localPoints.push_back(local);
 
-    // 2. Connect every particle to every other particle to ensure total rigidity
-    for (size_t i = 0; i < particles.size(); i++) {
-        for (size_t j = i + 1; j < particles.size(); j++) {
-            float dist = glm::distance(particles[i]->position, particles[j]->position);
-            springs.push_back(new SpringDamper(particles[i], particles[j], ks, kd, dist));
+                // Corners follow the body, so they are never integrated as free particles
+                Particle* p = new Particle(center + local, pMass);
+                p->isFixed = true;
+                particles.push_back(p);
+            }
         }
     }
 
-    // 3. Define indices for the 6 faces (12 triangles)
+    // 2. Define indices for the 6 faces (12 triangles)
     // Particle layout (x,y,z): 0(-,-,-), 1(+,-,-), 2(-,+,-), 3(+,+,-),
     //                           4(-,-,+), 5(+,-,+), 6(-,+,+), 7(+,+,+)
     indices = {
@@ -46,39 +43,48 @@ Cube::Cube(glm::vec3 center, float size, float mass){
     };
 
     vertexData.resize(8 * 6); // 8 vertices, 6 floats each (pos + normal)
-    SetupMesh();
+    interpolate = false;
+    VAO = 0;
+    StorePreviousPositions();
 }
 
-void Cube::UpdatePhysics(float deltaTime) {
-    glm::vec3 gravity(0.0f, -9.81f, 0.0f);
-    
-    // Apply gravity
+void Cube::ClearForces() {
+    body.ClearForces();
     for (Particle* p : particles) {
         p->ClearForces();
-        p->ApplyForce(gravity * p->mass);
-    }
-
-    // Compute spring forces
-    for (SpringDamper* s : springs) {
-        s->ComputeForce();
     }
+}
 
-    // Integrate and handle ground collision (similar to your cloth logic)
-    float groundY = -10.0f;
+void Cube::Integrate(float deltaTime, const ColliderSet& colliders) {
+    glm::vec3 gravity(0.0f, -9.81f, 0.0f);
     float groundRestitution = 0.3f; // Less bouncy than cloth
     float groundFriction = 0.8f;
 
+    // 1. Forces that springs (e.g. ropes) applied to the corners act on the body at that point
     for (Particle* p : particles) {
-        p->Update(deltaTime);
-        if (p->position.y < groundY) {
-            p->position.y = groundY;
-            p->velocity.y = -p->velocity.y * groundRestitution;
-            p->velocity.x *= (1.0f - groundFriction);
-            p->velocity.z *= (1.0f - groundFriction);
-        }
+        body.ApplyForceAtPoint(p->forceAccumulator, p->position);
+    }
+    body.ApplyForce(gravity * body.mass);
+
+    // 2. Integrate the rigid body and resolve its contacts
+    body.Update(deltaTime);
+    body.ResolveContacts(colliders, groundRestitution, groundFriction);
+
+    // 3. Move the corner particles with the body
+    for (size_t i = 0; i < particles.size(); i++) {
+        body.SyncAttachment(*particles[i], i);
     }
 }
 
+void Cube::UpdatePhysics(float deltaTime, const ColliderSet& colliders) {
+    ClearForces();
+    Integrate(deltaTime, colliders);
+}
+
+void Cube::SetFixed(bool fixed) {
+    body.isFixed = fixed;
+}
+
 void Cube::SetupMesh() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
@@ -100,9 +106,23 @@ void Cube::SetupMesh() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
+    // Previous tick position attribute (Location 2)
+    glGenBuffers(1, &previousVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+    glBufferData(GL_ARRAY_BUFFER, previousPositions.size() * sizeof(glm::vec3), previousPositions.data(), GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(2);
+
     glBindVertexArray(0);
 }
 
+void Cube::StorePreviousPositions() {
+    previousPositions.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); i++) {
+        previousPositions[i] = particles[i]->position;
+    }
+}
+
 void Cube::UpdateMesh() {
     // Compute per-vertex normals by averaging face normals
     // First, reset all normals
@@ -139,10 +159,16 @@ void Cube::UpdateMesh() {
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferSubData(GL_ARRAY_BUFFER, 0, vertexData.size() * sizeof(float), vertexData.data());
+
+    if (interpolate) {
+        glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, previousPositions.size() * sizeof(glm::vec3), previousPositions.data());
+    }
 }
 
 void Cube::Draw(unsigned int shaderProgram) {
     glUseProgram(shaderProgram);
+    if (!VAO) SetupMesh();
     UpdateMesh();
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
@@ -0,0 +1,300 @@
+#include "GridCloth.h"
+#include "GridClothKernel.h"
+#include <algorithm> // For std::sort
+#include <cmath>
+#include <cstddef>
+
+GridCloth::GridCloth(int width, int height, float spacing, float totalMass) {
+    this->width = width;
+    this->height = height;
+    this->spacing = spacing;
+    this->totalMass = totalMass;
+
+    GridSpringFamilies(spacing, structural, shear, bend);
+    dragCoefficient = kGridDragCoefficient;
+    kRepel = 2000.0f;
+    colliders = ColliderSet::Ground();
+    windField = nullptr;
+    VAO = 0;
+
+    Reset();
+}
+
+GridCloth::~GridCloth() {
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
+}
+
+void GridCloth::Reset() {
+    size_t count = (size_t)width * height;
+    px.resize(count); py.resize(count); pz.resize(count);
+    vx.assign(count, 0.0f); vy.assign(count, 0.0f); vz.assign(count, 0.0f);
+    pinned.assign(count, 0);
+    m_fx.resize(count); m_fy.resize(count); m_fz.resize(count);
+    m_rowX.resize(width); m_rowY.resize(width); m_rowZ.resize(width);
+    m_particleMass = totalMass / count;
+
+    // Same rest pose as Cloth::InitCloth
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            size_t i = Index(x, y);
+            glm::vec3 p = GridRestPosition(x, y, width, spacing);
+            px[i] = p.x;
+            py[i] = p.y;
+            pz[i] = p.z;
+            pinned[i] = (y == 0);
+        }
+    }
+
+    m_cellStride = width + 1;
+    size_t cellCount = (size_t)m_cellStride * (height + 1);
+    for (std::vector<float>* a : { &m_drag1x, &m_drag1y, &m_drag1z, &m_drag2x, &m_drag2y, &m_drag2z }) {
+        a->assign(cellCount, 0.0f);
+    }
+}
+
+template <int DX, int DY>
+void GridCloth::RowSprings(int y, const SpringFamily& family) {
+    // Springs from (x, y) to (x + DX, y + DY) for the whole row. The forces are computed once
+    // into a row buffer, then added to both ends as two contiguous row updates.
+    static_assert(DY > 0 || (DY == 0 && DX > 0), "Each spring is visited from its first particle");
+    if (y + DY >= height) return;
+    const int xBegin = DX < 0 ? -DX : 0;
+    const int xEnd = DX > 0 ? width - DX : width;
+    const ptrdiff_t offset = (ptrdiff_t)DY * width + DX;
+    const float ks = family.springConstant, kd = family.dampingFactor, rest = family.restLength;
+
+    const float* __restrict pX = px.data() + (size_t)y * width;
+    const float* __restrict pY = py.data() + (size_t)y * width;
+    const float* __restrict pZ = pz.data() + (size_t)y * width;
+    const float* __restrict vX = vx.data() + (size_t)y * width;
+    const float* __restrict vY = vy.data() + (size_t)y * width;
+    const float* __restrict vZ = vz.data() + (size_t)y * width;
+    float* __restrict sX = m_rowX.data();
+    float* __restrict sY = m_rowY.data();
+    float* __restrict sZ = m_rowZ.data();
+
+    for (int x = xBegin; x < xEnd; x++) {
+        glm::vec3 e(pX[x + offset] - pX[x], pY[x + offset] - pY[x], pZ[x + offset] - pZ[x]);
+        glm::vec3 dv(vX[x + offset] - vX[x], vY[x + offset] - vY[x], vZ[x + offset] - vZ[x]);
+        float length;
+        float scale = GridSpringForceScale(e, dv, ks, kd, rest, length);
+        sX[x] = scale * e.x;
+        sY[x] = scale * e.y;
+        sZ[x] = scale * e.z;
+    }
+
+    float* fRows[3] = { m_fx.data() + (size_t)y * width, m_fy.data() + (size_t)y * width, m_fz.data() + (size_t)y * width };
+    const float* sRows[3] = { sX, sY, sZ };
+    for (int k = 0; k < 3; k++) {
+        float* __restrict f = fRows[k];
+        const float* __restrict force = sRows[k];
+        for (int x = xBegin; x < xEnd; x++) f[x] += force[x];
+        for (int x = xBegin; x < xEnd; x++) f[x + offset] -= force[x];
+    }
+}
+
+void GridCloth::ComputeCellDrag(const glm::vec3& windVelocity) {
+    // Per-vertex drag of both triangles of every cell (GridFaceDrag, one cell at a time)
+    float dragScale = kGridAirDensity * dragCoefficient / 12.0f;
+    float* outX[2] = { m_drag1x.data(), m_drag2x.data() };
+    float* outY[2] = { m_drag1y.data(), m_drag2y.data() };
+    float* outZ[2] = { m_drag1z.data(), m_drag2z.data() };
+    for (int cy = 0; cy < height - 1; cy++) {
+        for (int cx = 0; cx < width - 1; cx++) {
+            size_t faces[2][3];
+            GridCellFaces(Index(cx, cy), width, faces);
+            size_t cell = (size_t)(cy + 1) * m_cellStride + cx + 1;
+            for (int t = 0; t < 2; t++) {
+                size_t a = faces[t][0], b = faces[t][1], c = faces[t][2];
+                glm::vec3 pa(px[a], py[a], pz[a]), pb(px[b], py[b], pz[b]), pc(px[c], py[c], pz[c]);
+                glm::vec3 velocitySum(vx[a] + vx[b] + vx[c], vy[a] + vy[b] + vy[c], vz[a] + vz[b] + vz[c]);
+
+                glm::vec3 wind = windVelocity;
+                if (windField) wind += windField->Sample((pa + pb + pc) / 3.0f);
+                glm::vec3 crossProduct;
+                glm::vec3 force = GridFaceDrag(pa, pb, pc, velocitySum, wind, dragScale, crossProduct);
+                outX[t][cell] = force.x;
+                outY[t][cell] = force.y;
+                outZ[t][cell] = force.z;
+            }
+        }
+    }
+}
+
+void GridCloth::GatherDrag(int y) {
+    // (x, y) is TL of cell (x, y), TR of (x - 1, y), BL of (x, y - 1) and BR of (x - 1, y - 1).
+    // Cells outside the sheet are the zero padding.
+    size_t here = (size_t)(y + 1) * m_cellStride + 1; // Padded cell (0, y)
+    size_t above = here - m_cellStride;              // Padded cell (0, y - 1)
+    size_t row = (size_t)y * width;
+    const float* a1[3] = { m_drag1x.data(), m_drag1y.data(), m_drag1z.data() };
+    const float* a2[3] = { m_drag2x.data(), m_drag2y.data(), m_drag2z.data() };
+    float* f[3] = { m_fx.data(), m_fy.data(), m_fz.data() };
+    for (int k = 0; k < 3; k++) {
+        const float* __restrict d1 = a1[k];
+        const float* __restrict d2 = a2[k];
+        float* __restrict out = f[k] + row;
+        for (int x = 0; x < width; x++) {
+            out[x] += d1[here + x]
+                    + d1[here + x - 1] + d2[here + x - 1]
+                    + d1[above + x] + d2[above + x]
+                    + d2[above + x - 1];
+        }
+    }
+}
+
+void GridCloth::SelfCollide() {
+    // Same sweep and prune along x as Cloth
+    float selfCollisionPoints = 0.3f;
+    // Last step's order is nearly sorted already, so it is kept and re-sorted
+    if (m_sorted.size() != px.size()) {
+        m_sorted.resize(px.size());
+        for (unsigned int i = 0; i < m_sorted.size(); i++) m_sorted[i] = i;
+    }
+    std::sort(m_sorted.begin(), m_sorted.end(), [this](unsigned int a, unsigned int b) { return px[a] < px[b]; });
+
+    for (size_t s = 0; s < m_sorted.size(); ++s) {
+        unsigned int i = m_sorted[s];
+        for (size_t t = s + 1; t < m_sorted.size(); ++t) {
+            unsigned int j = m_sorted[t];
+            if (px[j] - px[i] > selfCollisionPoints) break;
+            if (pinned[i] && pinned[j]) continue;
+
+            glm::vec3 diff(px[i] - px[j], py[i] - py[j], pz[i] - pz[j]);
+            float dist2 = glm::dot(diff, diff);
+            if (dist2 < selfCollisionPoints * selfCollisionPoints) {
+                float dist = std::sqrt(dist2);
+                if (dist > 0.0001f) {
+                    glm::vec3 force = diff / dist * (selfCollisionPoints - dist) * kRepel;
+                    m_fx[i] += force.x; m_fy[i] += force.y; m_fz[i] += force.z;
+                    m_fx[j] -= force.x; m_fy[j] -= force.y; m_fz[j] -= force.z;
+                }
+            }
+        }
+    }
+}
+
+void GridCloth::UpdatePhysics(float deltaTime, const glm::vec3& windVelocity) {
+    size_t count = px.size();
+
+    // 1. Gravity
+    std::fill(m_fx.begin(), m_fx.end(), 0.0f);
+    std::fill(m_fy.begin(), m_fy.end(), -9.81f * m_particleMass);
+    std::fill(m_fz.begin(), m_fz.end(), 0.0f);
+
+    // 2. Row by row: the 6 forward springs of the 12-neighbour stencil (each direction a
+    // template instance, so the offsets are constants), then the drag gather
+    const SpringFamily* families[3] = { &structural, &shear, &bend };
+    ComputeCellDrag(windVelocity);
+    for (int y = 0; y < height; y++) {
+        RowSprings<kGridSprings[0].dx, kGridSprings[0].dy>(y, *families[kGridSprings[0].family]);
+        RowSprings<kGridSprings[1].dx, kGridSprings[1].dy>(y, *families[kGridSprings[1].family]);
+        RowSprings<kGridSprings[2].dx, kGridSprings[2].dy>(y, *families[kGridSprings[2].family]);
+        RowSprings<kGridSprings[3].dx, kGridSprings[3].dy>(y, *families[kGridSprings[3].family]);
+        RowSprings<kGridSprings[4].dx, kGridSprings[4].dy>(y, *families[kGridSprings[4].family]);
+        RowSprings<kGridSprings[5].dx, kGridSprings[5].dy>(y, *families[kGridSprings[5].family]);
+        static_assert(kGridSpringDirections == 6, "One RowSprings per stencil direction");
+        GatherDrag(y);
+    }
+
+    // 3. Self-collision
+    SelfCollide();
+
+    // 4. Semi-implicit Euler (pinned particles don't move)
+    float invMass = 1.0f / m_particleMass;
+    for (size_t i = 0; i < count; i++) {
+        if (pinned[i]) continue;
+        vx[i] += m_fx[i] * invMass * deltaTime;
+        vy[i] += m_fy[i] * invMass * deltaTime;
+        vz[i] += m_fz[i] * invMass * deltaTime;
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        pz[i] += vz[i] * deltaTime;
+    }
+
+    // 5. Ground and obstacles (same response as Cloth)
+    m_points.resize(count);
+    m_distances.resize(count);
+    m_normals.resize(count);
+    for (size_t i = 0; i < count; i++) m_points[i] = glm::vec3(px[i], py[i], pz[i]);
+    colliders.Query(m_points.data(), count, m_distances.data(), m_normals.data());
+    for (size_t i = 0; i < count; i++) {
+        if (m_distances[i] >= kGridColliderThickness || pinned[i]) continue;
+        Particle p(m_points[i], m_particleMass);
+        p.velocity = glm::vec3(vx[i], vy[i], vz[i]);
+        ColliderSet::Respond(p, m_distances[i], m_normals[i], kGridColliderThickness, kGridColliderRestitution, kGridColliderFriction);
+        px[i] = p.position.x; py[i] = p.position.y; pz[i] = p.position.z;
+        vx[i] = p.velocity.x; vy[i] = p.velocity.y; vz[i] = p.velocity.z;
+    }
+}
+
+void GridCloth::SetupMesh() {
+    indices.clear();
+    for (int y = 0; y < height - 1; ++y) {
+        for (int x = 0; x < width - 1; ++x) {
+            unsigned int tl = (unsigned int)Index(x, y), tr = tl + 1;
+            unsigned int bl = tl + width, br = bl + 1;
+            indices.insert(indices.end(), { tl, bl, tr, tr, bl, br });
+        }
+    }
+    vertexData.resize(px.size() * 6);
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+}
+
+void GridCloth::UpdateMesh() {
+    // Normals only matter for drawing, so they are built here from the triangle stencil
+    auto position = [this](int x, int y) { size_t i = Index(x, y); return glm::vec3(px[i], py[i], pz[i]); };
+    auto faceCross = [&](int cx, int cy, int t) {
+        if (cx < 0 || cy < 0 || cx >= width - 1 || cy >= height - 1) return glm::vec3(0.0f);
+        glm::vec3 tl = position(cx, cy), tr = position(cx + 1, cy);
+        glm::vec3 bl = position(cx, cy + 1), br = position(cx + 1, cy + 1);
+        return t == 0 ? glm::cross(bl - tl, tr - tl) : glm::cross(bl - tr, br - tr);
+    };
+
+    int index = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            glm::vec3 n = faceCross(x, y, 0)
+                        + faceCross(x - 1, y, 0) + faceCross(x - 1, y, 1)
+                        + faceCross(x, y - 1, 0) + faceCross(x, y - 1, 1)
+                        + faceCross(x - 1, y - 1, 1);
+            n = glm::length(n) > 0.0f ? glm::normalize(n) : glm::vec3(0.0f, 1.0f, 0.0f);
+            glm::vec3 p = position(x, y);
+            vertexData[index++] = p.x;
+            vertexData[index++] = p.y;
+            vertexData[index++] = p.z;
+            vertexData[index++] = n.x;
+            vertexData[index++] = n.y;
+            vertexData[index++] = n.z;
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertexData.size() * sizeof(float), vertexData.data());
+}
+
+void GridCloth::Draw(unsigned int shaderProgram) {
+    glUseProgram(shaderProgram);
+    if (!VAO) SetupMesh();
+    UpdateMesh();
+
+    glBindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,200 @@
+#include "GridMultigrid.h"
+#include "ParallelFor.h"
+#include <algorithm> // For std::min
+#include <cmath>
+
+GridMultigrid::GridMultigrid() {
+    smoothingSweeps = 2;
+    coarsestSize = 8;
+    m_valid = false;
+}
+
+// Bilinear prolongation from the (width + 1) / 2 x (height + 1) / 2 grid to width x height
+static SparseMatrix BuildProlongation(int width, int height) {
+    int coarseWidth = (width + 1) / 2, coarseHeight = (height + 1) / 2;
+
+    // Per axis: an even fine index sits on a coarse node, an odd one halves between two
+    // (or copies the last node when it has no right/upper neighbour)
+    auto weights = [](int fine, int coarseCount, int* nodes, float* w) {
+        int c = fine / 2;
+        if (fine % 2 == 0 || c + 1 >= coarseCount) {
+            nodes[0] = c; w[0] = 1.0f;
+            return 1;
+        }
+        nodes[0] = c;     w[0] = 0.5f;
+        nodes[1] = c + 1; w[1] = 0.5f;
+        return 2;
+    };
+
+    std::vector<SparseMatrix::Entry> entries;
+    entries.reserve((size_t)width * height * 4);
+    for (int y = 0; y < height; y++) {
+        int ny[2]; float wy[2];
+        int countY = weights(y, coarseHeight, ny, wy);
+        for (int x = 0; x < width; x++) {
+            int nx[2]; float wx[2];
+            int countX = weights(x, coarseWidth, nx, wx);
+            for (int j = 0; j < countY; j++) {
+                for (int i = 0; i < countX; i++) {
+                    entries.push_back({ (unsigned int)(y * width + x), (unsigned int)(ny[j] * coarseWidth + nx[i]),
+                                        (double)(wy[j] * wx[i]) });
+                }
+            }
+        }
+    }
+    SparseMatrix P;
+    P.Build((size_t)width * height, (size_t)coarseWidth * coarseHeight, entries);
+    return P;
+}
+
+static double Dot(const glm::vec3* a, const glm::vec3* b, size_t n) {
+    return ParallelReduce(0, n, 0.0, [&](size_t begin, size_t end) {
+        double sum = 0.0;
+        for (size_t i = begin; i < end; i++) sum += glm::dot(a[i], b[i]);
+        return sum;
+    }, [](double x, double y) { return x + y; }, 16384);
+}
+
+static double Dot(const std::vector<glm::vec3>& a, const std::vector<glm::vec3>& b) {
+    return Dot(a.data(), b.data(), a.size());
+}
+
+bool GridMultigrid::Build(int width, int height, const SparseMatrix& A) {
+    m_levels.clear();
+    m_valid = false;
+    if (width <= 0 || height <= 0 || A.Rows() != (size_t)width * height) return false;
+
+    // 1. Coarsen until the grid is small enough to factor
+    m_levels.push_back(Level());
+    m_levels[0].width = width;
+    m_levels[0].height = height;
+    m_levels[0].A = A;
+    while (m_levels.back().width > coarsestSize && m_levels.back().height > coarsestSize) {
+        Level& fine = m_levels.back();
+        fine.P = BuildProlongation(fine.width, fine.height);
+        fine.R = fine.P.Transpose();
+
+        Level coarse;
+        coarse.width = (fine.width + 1) / 2;
+        coarse.height = (fine.height + 1) / 2;
+        coarse.A = SparseMatrix::Galerkin(fine.A, fine.P);
+        m_levels.push_back(coarse);
+    }
+
+    // 2. Smoother diagonals and scratch
+    for (Level& level : m_levels) {
+        size_t n = level.A.Rows();
+        level.invDiagonal.resize(n);
+        for (size_t row = 0; row < n; row++) {
+            float sum = 0.0f;
+            for (size_t e = level.A.RowBegin(row); e < level.A.RowEnd(row); e++) sum += std::abs(level.A.Value(e));
+            level.invDiagonal[row] = sum > 0.0f ? 1.0f / sum : 0.0f;
+        }
+        level.b.resize(n);
+        level.x.resize(n);
+        level.r.resize(n);
+    }
+
+    // 3. Direct solve on the coarsest level (still grid-ordered, so the skyline is a band)
+    const SparseMatrix& coarsest = m_levels.back().A;
+    size_t n = coarsest.Rows();
+    std::vector<unsigned int> firstColumn(n);
+    for (size_t row = 0; row < n; row++) {
+        firstColumn[row] = (unsigned int)row;
+        if (coarsest.RowBegin(row) < coarsest.RowEnd(row)) {
+            firstColumn[row] = std::min(firstColumn[row], coarsest.Column(coarsest.RowBegin(row)));
+        }
+    }
+    m_coarsest.SetProfile(firstColumn);
+    for (size_t row = 0; row < n; row++) {
+        for (size_t e = coarsest.RowBegin(row); e < coarsest.RowEnd(row); e++) {
+            if (coarsest.Column(e) <= row) m_coarsest.Add((unsigned int)row, coarsest.Column(e), coarsest.Value(e));
+        }
+    }
+    m_valid = m_coarsest.Factor();
+    return m_valid;
+}
+
+void GridMultigrid::Smooth(Level& level, const glm::vec3* b, glm::vec3* x) {
+    for (int sweep = 0; sweep < smoothingSweeps; sweep++) {
+        level.A.Multiply(x, level.r.data());
+        ParallelFor(0, level.r.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) x[i] += level.invDiagonal[i] * (b[i] - level.r[i]);
+        }, 16384);
+    }
+}
+
+void GridMultigrid::Cycle(size_t index, const glm::vec3* b, glm::vec3* x) {
+    Level& level = m_levels[index];
+    if (index + 1 == m_levels.size()) {
+        // Coarsest: exact solve
+        std::copy(b, b + level.A.Rows(), x);
+        m_coarsest.Solve(x);
+        return;
+    }
+
+    // 1. Pre-smooth, then restrict the residual
+    Smooth(level, b, x);
+    level.A.Multiply(x, level.r.data());
+    for (size_t i = 0; i < level.r.size(); i++) level.r[i] = b[i] - level.r[i];
+    Level& coarse = m_levels[index + 1];
+    level.R.Multiply(level.r.data(), coarse.b.data());
+
+    // 2. Coarse correction from a zero guess, interpolated back
+    std::fill(coarse.x.begin(), coarse.x.end(), glm::vec3(0.0f));
+    Cycle(index + 1, coarse.b.data(), coarse.x.data());
+    level.P.Multiply(coarse.x.data(), level.r.data());
+    for (size_t i = 0; i < level.r.size(); i++) x[i] += level.r[i];
+
+    // 3. Post-smooth (same sweeps, so the cycle stays a symmetric preconditioner)
+    Smooth(level, b, x);
+}
+
+void GridMultigrid::VCycle(const glm::vec3* b, glm::vec3* x) {
+    if (!m_valid) return;
+    Cycle(0, b, x);
+}
+
+int GridMultigrid::SolvePCG(const glm::vec3* b, glm::vec3* x, int maxIterations, float tolerance) {
+    if (!m_valid) return 0;
+    const SparseMatrix& A = m_levels[0].A;
+    size_t n = A.Rows();
+    m_residual.resize(n);
+    m_preconditioned.resize(n);
+    m_direction.resize(n);
+    m_product.resize(n);
+
+    // r = b - A x, z = M^-1 r, p = z
+    A.Multiply(x, m_product.data());
+    for (size_t i = 0; i < n; i++) m_residual[i] = b[i] - m_product[i];
+    double bNorm2 = Dot(b, b, n);
+    double stop2 = (double)tolerance * tolerance * bNorm2;
+    if (Dot(m_residual, m_residual) <= stop2) return 0;
+
+    std::fill(m_preconditioned.begin(), m_preconditioned.end(), glm::vec3(0.0f));
+    Cycle(0, m_residual.data(), m_preconditioned.data());
+    m_direction = m_preconditioned;
+    double rz = Dot(m_residual, m_preconditioned);
+
+    int iteration = 0;
+    while (iteration < maxIterations) {
+        iteration++;
+        A.Multiply(m_direction.data(), m_product.data());
+        double pAp = Dot(m_direction, m_product);
+        if (pAp <= 0.0) break;
+        float alpha = (float)(rz / pAp);
+        for (size_t i = 0; i < n; i++) {
+            x[i] += alpha * m_direction[i];
+            m_residual[i] -= alpha * m_product[i];
+        }
+        if (Dot(m_residual, m_residual) <= stop2) break;
+
+        std::fill(m_preconditioned.begin(), m_preconditioned.end(), glm::vec3(0.0f));
+        Cycle(0, m_residual.data(), m_preconditioned.data());
+        double rzNext = Dot(m_residual, m_preconditioned);
+        float beta = (float)(rzNext / rz);
+        rz = rzNext;
+        for (size_t i = 0; i < n; i++) m_direction[i] = m_preconditioned[i] + beta * m_direction[i];
+    }
+    return iteration;
+}
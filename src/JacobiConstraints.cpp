@@ -0,0 +1,109 @@
+#include "JacobiConstraints.h"
+#include "ParallelFor.h"
+#include <cmath>
+
+// Pairs within this multiple of their distance count as in contact after the iterations
+// (the last iterate is not fully converged, so touching pairs may sit slightly apart)
+static const float kContactSlack = 1.01f;
+
+JacobiConstraints::JacobiConstraints() {
+    iterations = 8;
+    relaxation = 1.0f;
+    spectralRadius = 0.9f;
+    chebyshevDelay = 2;
+}
+
+void JacobiConstraints::BuildAdjacency(size_t count) {
+    // Counting sort of the constraint ends by particle
+    m_offsets.assign(count + 1, 0);
+    for (const Constraint& c : m_constraints) {
+        m_offsets[c.a + 1]++;
+        m_offsets[c.b + 1]++;
+    }
+    for (size_t i = 0; i < count; i++) m_offsets[i + 1] += m_offsets[i];
+    m_particleConstraints.resize(m_offsets[count]);
+    std::vector<unsigned int> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    for (unsigned int c = 0; c < m_constraints.size(); c++) {
+        m_particleConstraints[cursor[m_constraints[c].a]++] = c;
+        m_particleConstraints[cursor[m_constraints[c].b]++] = c;
+    }
+}
+
+void JacobiConstraints::Solve(Particle* const* particles, size_t count) {
+    if (m_constraints.empty() || count == 0) return;
+    BuildAdjacency(count);
+
+    m_current.resize(count);
+    m_next.resize(count);
+    m_weights.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_current[i] = particles[i]->position;
+        m_weights[i] = particles[i]->isFixed ? 0.0f : 1.0f;
+    }
+    m_previous = m_current;
+
+    float omega = 1.0f;
+    float rho2 = spectralRadius * spectralRadius;
+    for (int k = 0; k < iterations; k++) {
+        // 1. Chebyshev weight for this iteration (1 = plain Jacobi)
+        if (rho2 <= 0.0f || k < chebyshevDelay) omega = 1.0f;
+        else if (k == chebyshevDelay) omega = 2.0f / (2.0f - rho2);
+        else omega = 4.0f / (4.0f - rho2 * omega);
+
+        // 2. Every particle averages the corrections of its violated constraints, reading only x_k
+        ParallelFor(0, count, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                glm::vec3 x = m_current[i];
+                glm::vec3 sum(0.0f);
+                int active = 0;
+                if (m_weights[i] > 0.0f) {
+                    for (unsigned int e = m_offsets[i]; e < m_offsets[i + 1]; e++) {
+                        const Constraint& c = m_constraints[m_particleConstraints[e]];
+                        unsigned int j = c.a == i ? c.b : c.a;
+                        glm::vec3 diff = x - m_current[j];
+                        float dist2 = glm::dot(diff, diff);
+                        if (dist2 >= c.distance * c.distance || dist2 <= 0.00001f) continue;
+                        float dist = std::sqrt(dist2);
+                        // This particle's share of the overlap (all of it against a fixed one)
+                        float share = m_weights[i] / (m_weights[i] + m_weights[j]);
+                        sum += diff * ((c.distance - dist) * share / dist);
+                        active++;
+                    }
+                }
+                glm::vec3 jacobi = active > 0 ? x + sum * (relaxation / active) : x;
+                m_next[i] = omega * (jacobi - m_previous[i]) + m_previous[i];
+            }
+        }, 2048);
+
+        m_previous.swap(m_current); // x_{k-1} <- x_k
+        m_current.swap(m_next);     // x_k <- x_{k+1}
+    }
+
+    // 3. Remove the approach velocity of every pair still in contact, reading the velocities from before
+    m_velocityChange.resize(count);
+    ParallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            glm::vec3 change(0.0f);
+            if (m_weights[i] > 0.0f) {
+                for (unsigned int e = m_offsets[i]; e < m_offsets[i + 1]; e++) {
+                    const Constraint& c = m_constraints[m_particleConstraints[e]];
+                    unsigned int j = c.a == i ? c.b : c.a;
+                    glm::vec3 diff = m_current[i] - m_current[j];
+                    float dist2 = glm::dot(diff, diff);
+                    float contact = c.distance * kContactSlack;
+                    if (dist2 >= contact * contact || dist2 <= 0.00001f) continue;
+                    glm::vec3 dir = diff / std::sqrt(dist2);
+                    float approach = glm::dot(particles[i]->velocity - particles[j]->velocity, dir);
+                    if (approach < 0.0f) change -= dir * (approach * 0.5f);
+                }
+            }
+            m_velocityChange[i] = change;
+        }
+    }, 2048);
+
+    for (size_t i = 0; i < count; i++) {
+        if (m_weights[i] == 0.0f) continue;
+        particles[i]->position = m_current[i];
+        particles[i]->velocity += m_velocityChange[i];
+    }
+}
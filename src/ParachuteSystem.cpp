@@ -1,10 +1,17 @@
 #include "ParachuteSystem.h"
 #include <algorithm>
-#include <cfloat>
+#include <unordered_map>
 
 ParachuteSystem::ParachuteSystem(glm::vec3 dropPosition) {
     falling = false;
     m_dropPosition = dropPosition;
+    colliders = ColliderSet::Ground();
+    windField = nullptr;
+    interpolate = false;
+    dragCoefficient = 3.0f; // High drag for parachute canopy
+    jacobiSelfCollision = false;
+    exactRopes = false;
+    lineVAO = 0;
 
     // 1. Create canopy cloth — reposition to lay FLAT (X-Z plane) with dome shape
     int gridW = 20, gridH = 20;
@@ -36,24 +43,19 @@ ParachuteSystem::ParachuteSystem(glm::vec3 dropPosition) {
     canopy->particles[gridW * (gridH - 1) + gridW - 1]->mass = cornerMass;
 
     // Stiffen canopy springs for parachute (Scene 1 uses default Cloth values)
-    for (auto s : canopy->springs) {
-        s->springConstant *= 3.0f;  // Stiff fabric to hold dome shape
-        s->dampingFactor  *= 2.0f;
-    }
+    canopy->ScaleStiffness(3.0f, 2.0f); // Stiff fabric to hold dome shape
 
     // 2. Create a heavy crate well below the canopy
     crate = new Cube(dropPosition - glm::vec3(0.0f, 12.0f, 0.0f), 2.0f, 10.0f);
     
-    // Fix all crate particles too (frozen until space)
-    for(auto p : crate->particles) {
-        p->isFixed = true;
-    }
+    // Freeze the crate too (frozen until space)
+    crate->SetFixed(true);
 
     // 3. Create rope chains
     CreateRopes();
 
-    // 4. Initialize OpenGL buffers for rendering the lines
-    SetupLineMesh();
+    // 4. The line buffers are created on the first DrawLines
+    StorePreviousPositions();
 }
 
 ParachuteSystem::~ParachuteSystem() {
@@ -62,8 +64,11 @@ ParachuteSystem::~ParachuteSystem() {
     for (auto r : ropes) delete r;
     for (auto p : ropeParticles) delete p;
     
-    glDeleteVertexArrays(1, &lineVAO);
-    glDeleteBuffers(1, &lineVBO);
+    if (lineVAO) {
+        glDeleteVertexArrays(1, &lineVAO);
+        glDeleteBuffers(1, &lineVBO);
+        glDeleteBuffers(1, &lineEBO);
+    }
 }
 
 void ParachuteSystem::CreateRopes() {
@@ -89,12 +94,14 @@ void ParachuteSystem::CreateRopes() {
         crate->particles[7]
     };
 
+    ropeSolver.Clear();
     for (int r = 0; r < 4; r++) {
         Particle* start = clothCorners[r];
         Particle* end = crateCorners[r];
 
         Particle* prev = start;
         float segmentLength = glm::distance(start->position, end->position) / segments;
+        std::vector<Particle*> chain = { start };
 
         for (int i = 1; i < segments; i++) {
             float t = (float)i / (float)segments;
@@ -102,12 +109,27 @@ void ParachuteSystem::CreateRopes() {
             Particle* p = new Particle(pos, ropeMassPerParticle);
             p->isFixed = !falling;
             ropeParticles.push_back(p);
+            chain.push_back(p);
 
             ropes.push_back(new SpringDamper(prev, p, ropeKs, ropeKd, segmentLength));
             prev = p;
         }
 
         ropes.push_back(new SpringDamper(prev, end, ropeKs, ropeKd, segmentLength));
+        chain.push_back(end);
+        ropeSolver.Add(chain, segmentLength, &crate->body);
+    }
+
+    // Line mesh: one vertex per distinct rope particle, one index pair per spring
+    ropeVertices.clear();
+    ropeLineIndices.clear();
+    std::unordered_map<Particle*, unsigned int> vertexOf;
+    for (SpringDamper* s : ropes) {
+        for (Particle* p : { s->p1, s->p2 }) {
+            auto inserted = vertexOf.emplace(p, (unsigned int)ropeVertices.size());
+            if (inserted.second) ropeVertices.push_back(p);
+            ropeLineIndices.push_back(inserted.first->second);
+        }
     }
 }
 
@@ -117,50 +139,51 @@ void ParachuteSystem::UpdatePhysics(float deltaTime, const glm::vec3& wind) {
 
     glm::vec3 gravity(0.0f, -9.81f, 0.0f);
     float airDensity = 1.225f;
-    float dragCoefficient = 3.0f;  // High drag for parachute canopy
     float velocityDamping = 0.995f;
-    float groundY = -10.0f;
     float groundRestitution = 0.3f;
     float groundFriction = 0.8f;
 
     // ===== PHASE 1: CLEAR ALL FORCES =====
     for (auto p : canopy->particles) {
-        p->normal = glm::vec3(0.0f);
-        p->ClearForces();
-    }
-    for (auto p : crate->particles) {
+        if (!canopy->gpuNormals) p->normal = glm::vec3(0.0f);
         p->ClearForces();
     }
+    crate->ClearForces();
     for (auto p : ropeParticles) {
         p->ClearForces();
     }
 
-    // ===== PHASE 2: APPLY GRAVITY TO ALL =====
-    for (auto p : canopy->particles) p->ApplyForce(gravity * p->mass);
-    for (auto p : crate->particles)  p->ApplyForce(gravity * p->mass);
-    for (auto p : ropeParticles)     p->ApplyForce(gravity * p->mass);
+    // ===== PHASE 2: APPLY GRAVITY TO ALL (and sum the energies on the way) =====
+    // (The crate applies gravity to its rigid body when it integrates)
+    diagnostics.Clear();
+    for (auto p : canopy->particles) {
+        p->ApplyForce(gravity * p->mass);
+        diagnostics.AddParticle(*p, -gravity.y);
+    }
+    for (auto p : ropeParticles) {
+        p->ApplyForce(gravity * p->mass);
+        diagnostics.AddParticle(*p, -gravity.y);
+    }
+    const RigidBody& body = crate->body;
+    diagnostics.AddBody(body.mass, body.velocity, body.position.y, -gravity.y);
+    diagnostics.kineticEnergy += 0.5f * glm::dot(body.angularMomentum, body.angularVelocity);
 
     // ===== PHASE 3: COMPUTE ALL SPRING FORCES =====
     // Canopy internal springs (structural, shear, bending)
-    for (auto sd : canopy->springs) {
-        sd->ComputeForce();
-    }
-    // Crate internal springs (rigidity)
-    for (auto s : crate->springs) {
-        s->ComputeForce();
-    }
+    canopy->ComputeSpringForces(&diagnostics);
     // Rope springs (connect canopy <-> rope particles <-> crate)
-    // These now correctly apply forces to canopy and crate particles
+    // These now correctly apply forces to canopy and crate attachment points
     // BEFORE integration, so the coupling is bidirectional.
-    for (auto r : ropes) {
-        r->ComputeForce();
+    // (Exact ropes add their link forces last, in phase 9, once every other force is known.)
+    if (!exactRopes) {
+        for (auto r : ropes) {
+            r->ComputeForce(&diagnostics);
+        }
     }
 
     // ===== PHASE 4: AERODYNAMIC FORCES ON CANOPY =====
-    for (auto t : canopy->triangles) {
-        t->ComputeNormal();
-        t->ComputeAerodynamicForce(wind, airDensity, dragCoefficient);
-    }
+    Triangle::ComputeNormalsAndAerodynamics(canopy->particles.data(), canopy->indices.data(), canopy->indices.size() / 3,
+                                            wind, airDensity, dragCoefficient, windField, !canopy->gpuNormals);
 
     // ===== PHASE 5: CANOPY SELF-COLLISION (position-based) =====
     // Position-based correction is more robust than force-based for preventing penetration
@@ -175,6 +198,7 @@ void ParachuteSystem::UpdatePhysics(float deltaTime, const glm::vec3& wind) {
     std::sort(sortedParticles.begin(), sortedParticles.end(), [](Particle* a, Particle* b) {
         return a->position.x < b->position.x;
     });
+    selfCollisionSolver.Clear();
     for (size_t i = 0; i < sortedParticles.size(); ++i) {
         Particle* p1 = sortedParticles[i];
         for (size_t j = i + 1; j < sortedParticles.size(); ++j) {
@@ -184,6 +208,11 @@ void ParachuteSystem::UpdatePhysics(float deltaTime, const glm::vec3& wind) {
             glm::vec3 diff = p1->position - p2->position;
             float dist2 = glm::dot(diff, diff);
             if (dist2 < (selfCollisionThresh * selfCollisionThresh) && dist2 > 0.00001f) {
+                if (jacobiSelfCollision) {
+                    // Only collect the pair (indices into sortedParticles); solved below
+                    selfCollisionSolver.Add((unsigned int)i, (unsigned int)j, selfCollisionThresh);
+                    continue;
+                }
                 float dist = sqrt(dist2);
                 glm::vec3 dir = diff / dist;
                 float overlap = selfCollisionThresh - dist;
@@ -210,60 +239,26 @@ void ParachuteSystem::UpdatePhysics(float deltaTime, const glm::vec3& wind) {
         }
     }
 
+    if (jacobiSelfCollision) selfCollisionSolver.Solve(sortedParticles.data(), sortedParticles.size());
+
     // ===== PHASE 6: VELOCITY DAMPING ON ROPES =====
-    for (auto p : ropeParticles) {
-        p->velocity *= velocityDamping;
+    // Only for the springs: inextensible links have no stretch oscillation to damp
+    if (!exactRopes) {
+        for (auto p : ropeParticles) {
+            p->velocity *= velocityDamping;
+        }
     }
 
-    // ===== PHASE 7: CANOPY/ROPE vs CUBE AABB COLLISION =====
-    // Compute the crate's axis-aligned bounding box from its particles
-    glm::vec3 crateMin(FLT_MAX), crateMax(-FLT_MAX);
-    for (auto cp : crate->particles) {
-        crateMin = glm::min(crateMin, cp->position);
-        crateMax = glm::max(crateMax, cp->position);
-    }
+    // ===== PHASE 7: CANOPY/ROPE vs CRATE BOX COLLISION =====
+    // The crate is rigid, so its exact oriented box comes from the body pose.
     // Add a small margin so particles don't clip through faces
     float margin = 0.15f;
-    crateMin -= glm::vec3(margin);
-    crateMax += glm::vec3(margin);
-
-    auto resolveAABB = [&](Particle* p) {
-        if (p->isFixed) return;
-        glm::vec3& pos = p->position;
-        // Check if particle is inside the AABB
-        if (pos.x > crateMin.x && pos.x < crateMax.x &&
-            pos.y > crateMin.y && pos.y < crateMax.y &&
-            pos.z > crateMin.z && pos.z < crateMax.z) {
-            // Find nearest face to push out along
-            float dx1 = pos.x - crateMin.x;
-            float dx2 = crateMax.x - pos.x;
-            float dy1 = pos.y - crateMin.y;
-            float dy2 = crateMax.y - pos.y;
-            float dz1 = pos.z - crateMin.z;
-            float dz2 = crateMax.z - pos.z;
-
-            float minPen = dx1;
-            glm::vec3 pushDir(-1, 0, 0);
-
-            if (dx2 < minPen) { minPen = dx2; pushDir = glm::vec3(1, 0, 0); }
-            if (dy1 < minPen) { minPen = dy1; pushDir = glm::vec3(0, -1, 0); }
-            if (dy2 < minPen) { minPen = dy2; pushDir = glm::vec3(0, 1, 0); }
-            if (dz1 < minPen) { minPen = dz1; pushDir = glm::vec3(0, 0, -1); }
-            if (dz2 < minPen) { minPen = dz2; pushDir = glm::vec3(0, 0, 1); }
-
-            // Push particle out
-            pos += pushDir * minPen;
-
-            // Kill velocity into the box
-            float velInto = glm::dot(p->velocity, -pushDir);
-            if (velInto > 0.0f) {
-                p->velocity += pushDir * velInto * 1.1f; // Slight bounce
-            }
-        }
-    };
+    crateCollider.Clear();
+    crateCollider.AddBox(crate->body.position, glm::vec3(crate->halfSize + margin), glm::mat3_cast(crate->body.orientation));
 
-    for (auto p : canopy->particles) resolveAABB(p);
-    for (auto p : ropeParticles) resolveAABB(p);
+    // Push particles inside out to the nearest face and kill velocity into the box (slight bounce)
+    crateCollider.ResolveParticles(canopy->particles.data(), canopy->particles.size(), 0.0f, 0.1f, 0.0f);
+    crateCollider.ResolveParticles(ropeParticles.data(), ropeParticles.size(), 0.0f, 0.1f, 0.0f);
 
     // ===== PHASE 8: CLAMP ACCELERATION (safety net) =====
     float maxAccel = 2000.0f;
@@ -276,43 +271,34 @@ void ParachuteSystem::UpdatePhysics(float deltaTime, const glm::vec3& wind) {
         }
     };
     for (auto p : canopy->particles) clampForce(p);
-    for (auto p : crate->particles)  clampForce(p);
     for (auto p : ropeParticles)     clampForce(p);
 
-    // ===== PHASE 9: INTEGRATE ALL PARTICLES =====
+    // ===== PHASE 9: EXACT ROPE LINKS =====
+    // After the clamp, so the constraint forces are applied in full
+    if (exactRopes) ropeSolver.ApplyForces(deltaTime, gravity, &diagnostics);
+
+    // ===== PHASE 10: INTEGRATE ALL PARTICLES =====
     // Canopy particles
     for (auto p : canopy->particles) {
-        if (glm::length(p->normal) > 0.0f) {
-            p->normal = glm::normalize(p->normal);
-        } else {
-            p->normal = glm::vec3(0.0f, 1.0f, 0.0f);
-        }
-        p->Update(deltaTime);
-        if (p->position.y < groundY + 0.05f) {
-            p->position.y = groundY + 0.05f;
-            p->velocity.y = -p->velocity.y * groundRestitution;
-            p->velocity.x *= (1.0f - groundFriction);
-            p->velocity.z *= (1.0f - groundFriction);
+        if (!canopy->gpuNormals) {
+            if (glm::length(p->normal) > 0.0f) {
+                p->normal = glm::normalize(p->normal);
+            } else {
+                p->normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            }
         }
-    }
-    // Crate particles
-    for (auto p : crate->particles) {
         p->Update(deltaTime);
-        if (p->position.y < groundY) {
-            p->position.y = groundY;
-            p->velocity.y = -p->velocity.y * groundRestitution;
-            p->velocity.x *= (1.0f - groundFriction);
-            p->velocity.z *= (1.0f - groundFriction);
-        }
     }
+    // Crate rigid body (rope forces on its corners become force + torque)
+    crate->Integrate(deltaTime, colliders);
     // Rope particles
     for (auto p : ropeParticles) {
         p->Update(deltaTime);
-        if (p->position.y < groundY) {
-            p->position.y = groundY;
-            p->velocity.y = -p->velocity.y * 0.3f;
-        }
     }
+
+    // ===== PHASE 11: GROUND AND OBSTACLES =====
+    colliders.ResolveParticles(canopy->particles.data(), canopy->particles.size(), 0.05f, groundRestitution, groundFriction);
+    colliders.ResolveParticles(ropeParticles.data(), ropeParticles.size(), 0.0f, 0.3f, 0.0f);
 }
 
 void ParachuteSystem::Reset() {
@@ -323,8 +309,12 @@ void ParachuteSystem::Reset() {
     ropes.clear();
     for (auto p : ropeParticles) delete p;
     ropeParticles.clear();
-    glDeleteVertexArrays(1, &lineVAO);
-    glDeleteBuffers(1, &lineVBO);
+    if (lineVAO) {
+        glDeleteVertexArrays(1, &lineVAO);
+        glDeleteBuffers(1, &lineVBO);
+        glDeleteBuffers(1, &lineEBO);
+        lineVAO = 0;
+    }
 
     // Rebuild everything from scratch
     falling = false;
@@ -354,18 +344,13 @@ void ParachuteSystem::Reset() {
     canopy->particles[gridW * (gridH - 1) + gridW - 1]->mass = cornerMass;
 
     // Stiffen canopy springs (same as constructor)
-    for (auto s : canopy->springs) {
-        s->springConstant *= 3.0f;
-        s->dampingFactor  *= 2.0f;
-    }
+    canopy->ScaleStiffness(3.0f, 2.0f);
 
     crate = new Cube(m_dropPosition - glm::vec3(0.0f, 12.0f, 0.0f), 2.0f, 10.0f);
-    for(auto p : crate->particles) {
-        p->isFixed = true;
-    }
+    crate->SetFixed(true);
 
     CreateRopes();
-    SetupLineMesh();
+    StorePreviousPositions();
 }
 
 void ParachuteSystem::StartFalling() {
@@ -376,10 +361,8 @@ void ParachuteSystem::StartFalling() {
     for(auto p : canopy->particles) {
         p->isFixed = false;
     }
-    // Unpin all crate particles 
-    for(auto p : crate->particles) {
-        p->isFixed = false;
-    }
+    // Release the crate rigid body
+    crate->SetFixed(false);
     // Unpin all rope particles
     for(auto p : ropeParticles) {
         p->isFixed = false;
@@ -389,47 +372,61 @@ void ParachuteSystem::StartFalling() {
 void ParachuteSystem::SetupLineMesh() {
     glGenVertexArrays(1, &lineVAO);
     glGenBuffers(1, &lineVBO);
+    glGenBuffers(1, &lineEBO);
 
     glBindVertexArray(lineVAO);
     glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-    
-    // Allocate enough space for all rope segments (2 vertices per line, 6 floats per vertex)
-    size_t maxLines = ropes.size();
-    glBufferData(GL_ARRAY_BUFFER, maxLines * 2 * 6 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+
+    // One slot per rope vertex (6 floats each); the CPU copy is sized here and never grows
+    lineVertexData.assign(ropeVertices.size() * 6, 0.0f);
+    glBufferData(GL_ARRAY_BUFFER, lineVertexData.size() * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+
+    // The segments never change, so the index buffer is uploaded once
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lineEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, ropeLineIndices.size() * sizeof(unsigned int), ropeLineIndices.data(), GL_STATIC_DRAW);
 
     // Position attribute (Location 0)
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
-    
-    // Normal attribute (Location 1)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+
+    // The normal (Location 1) is the same for every rope vertex, so it is not streamed:
+    // the array stays disabled and DrawLines sets the constant attribute value
+
+    // Previous tick position attribute (Location 2)
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
 
     glBindVertexArray(0);
 }
 
-void ParachuteSystem::DrawLines(unsigned int shaderProgram) {
-    lineVertexData.clear();
-
-    auto pushSpringLine = [&](SpringDamper* s) {
-        lineVertexData.push_back(s->p1->position.x);
-        lineVertexData.push_back(s->p1->position.y);
-        lineVertexData.push_back(s->p1->position.z);
-        lineVertexData.push_back(0.0f); lineVertexData.push_back(1.0f); lineVertexData.push_back(0.0f); 
-        
-        lineVertexData.push_back(s->p2->position.x);
-        lineVertexData.push_back(s->p2->position.y);
-        lineVertexData.push_back(s->p2->position.z);
-        lineVertexData.push_back(0.0f); lineVertexData.push_back(1.0f); lineVertexData.push_back(0.0f); 
-    };
+void ParachuteSystem::StorePreviousPositions() {
+    canopy->StorePreviousPositions();
+    crate->StorePreviousPositions();
+    previousRopePositions.resize(ropeVertices.size());
+    for (size_t i = 0; i < ropeVertices.size(); i++) {
+        previousRopePositions[i] = ropeVertices[i]->position;
+    }
+}
 
-    for (auto r : ropes) pushSpringLine(r);
+void ParachuteSystem::DrawLines(unsigned int shaderProgram) {
+    if (!lineVAO) SetupLineMesh();
+
+    // Overwrite the fixed-size array in place: each rope particle once, however many segments share it
+    float* v = lineVertexData.data();
+    for (size_t i = 0; i < ropeVertices.size(); i++) {
+        const glm::vec3& position = ropeVertices[i]->position;
+        const glm::vec3& previous = interpolate ? previousRopePositions[i] : position;
+        v[0] = position.x; v[1] = position.y; v[2] = position.z;
+        v[3] = previous.x; v[4] = previous.y; v[5] = previous.z;
+        v += 6;
+    }
 
     glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
     glBufferSubData(GL_ARRAY_BUFFER, 0, lineVertexData.size() * sizeof(float), lineVertexData.data());
 
     glBindVertexArray(lineVAO);
-    glDrawArrays(GL_LINES, 0, lineVertexData.size() / 6);
+    glVertexAttrib3f(1, 0.0f, 1.0f, 0.0f); // Current-attribute state is global, so set it per draw
+    glDrawElements(GL_LINES, ropeLineIndices.size(), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
 
@@ -0,0 +1,157 @@
+#include "ProjectiveDynamics.h"
+#include "ParallelFor.h"
+#include <algorithm> // For std::min
+
+ProjectiveDynamics::ProjectiveDynamics() {
+    iterations = 10;
+    multigrid = false;
+    multigridIterations = 20;
+    multigridTolerance = 1e-4f;
+    m_gridWidth = m_gridHeight = 0;
+    m_factorCount = 0;
+    m_lastSolveIterations = 0;
+    m_factorValid = false;
+    m_factorMultigrid = false;
+    m_factorDeltaTime = 0.0f;
+}
+
+void ProjectiveDynamics::SetSprings(const std::vector<Spring>& springs) {
+    m_springs = springs;
+    m_factorValid = false;
+}
+
+void ProjectiveDynamics::SetGrid(int width, int height) {
+    if (width == m_gridWidth && height == m_gridHeight) return;
+    m_gridWidth = width;
+    m_gridHeight = height;
+    if (m_factorMultigrid) m_factorValid = false;
+}
+
+bool ProjectiveDynamics::UseMultigrid(size_t count) const {
+    return multigrid && m_gridWidth > 0 && (size_t)m_gridWidth * m_gridHeight == count;
+}
+
+bool ProjectiveDynamics::NeedsFactor(Particle* const* particles, size_t count, float deltaTime) const {
+    // Exact comparison on purpose: a factor for a different h solves a different system.
+    // A fixed-rate caller passes the same value every step.
+    if (!m_factorValid || deltaTime != m_factorDeltaTime || count != m_factorPinned.size()) return true;
+    if (UseMultigrid(count) != m_factorMultigrid) return true;
+    for (size_t i = 0; i < count; i++) {
+        if ((unsigned char)particles[i]->isFixed != m_factorPinned[i] || particles[i]->mass != m_factorMass[i]) return true;
+    }
+    return false;
+}
+
+void ProjectiveDynamics::Factor(Particle* const* particles, size_t count, float deltaTime) {
+    // 1. M / h^2 + L over the free particles (lower triangle); pinned rows are the identity,
+    // and their couplings move to the right-hand side in Step
+    double invH2 = 1.0 / ((double)deltaTime * deltaTime);
+    std::vector<SparseMatrix::Entry> lower;
+    lower.reserve(count + 2 * m_springs.size());
+    m_factorPinned.resize(count);
+    m_factorMass.resize(count);
+    for (unsigned int i = 0; i < count; i++) {
+        m_factorPinned[i] = particles[i]->isFixed;
+        m_factorMass[i] = particles[i]->mass;
+        lower.push_back({ i, i, m_factorPinned[i] ? 1.0 : particles[i]->mass * invH2 });
+    }
+    for (const Spring& s : m_springs) {
+        bool freeA = !m_factorPinned[s.a], freeB = !m_factorPinned[s.b];
+        if (freeA) lower.push_back({ s.a, s.a, (double)s.weight });
+        if (freeB) lower.push_back({ s.b, s.b, (double)s.weight });
+        if (freeA && freeB) lower.push_back({ std::max(s.a, s.b), std::min(s.a, s.b), -(double)s.weight });
+    }
+
+    m_factorMultigrid = UseMultigrid(count);
+    if (m_factorMultigrid) {
+        // 2a. Full symmetric matrix for the multigrid hierarchy
+        std::vector<SparseMatrix::Entry> entries = lower;
+        for (const SparseMatrix::Entry& e : lower) {
+            if (e.row != e.col) entries.push_back({ e.col, e.row, e.value });
+        }
+        SparseMatrix A;
+        A.Build(count, count, entries);
+        m_factorValid = m_multigrid.Build(m_gridWidth, m_gridHeight, A);
+    } else {
+        // 2b. Skyline profile: each row reaches back to its furthest spring partner
+        std::vector<unsigned int> firstColumn(count);
+        for (unsigned int i = 0; i < count; i++) firstColumn[i] = i;
+        for (const SparseMatrix::Entry& e : lower) firstColumn[e.row] = std::min(firstColumn[e.row], e.col);
+        m_solver.SetProfile(firstColumn);
+        for (const SparseMatrix::Entry& e : lower) m_solver.Add(e.row, e.col, e.value);
+        m_factorValid = m_solver.Factor();
+    }
+    m_factorDeltaTime = deltaTime;
+    m_factorCount++;
+}
+
+void ProjectiveDynamics::Step(Particle* const* particles, size_t count, float deltaTime, SimDiagnostics* diagnostics) {
+    if (count == 0 || deltaTime <= 0.0f) return;
+    if (NeedsFactor(particles, count, deltaTime)) Factor(particles, count, deltaTime);
+    if (!m_factorValid) return; // Not positive definite (e.g. zero masses): leave the state alone
+
+    // 1. Inertial target y = x + h v + h^2 / m f_ext; the iteration starts from it
+    float h = deltaTime, invH2 = 1.0f / (h * h);
+    m_inertial.resize(count);
+    m_rhs.resize(count);
+    m_positions.resize(count);
+    std::vector<glm::vec3>& q = m_positions;
+    std::vector<glm::vec3>& b = m_rhs;
+    for (size_t i = 0; i < count; i++) {
+        const Particle& p = *particles[i];
+        m_inertial[i] = p.isFixed ? p.position : p.position + h * p.velocity + (h * h / p.mass) * p.forceAccumulator;
+        q[i] = m_inertial[i];
+    }
+
+    m_projections.resize(m_springs.size());
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        // 2. Local step: every spring independently projects onto its rest length
+        // (the spring energies come along for the diagnostics)
+        SimDiagnostics springs = ParallelReduce(0, m_springs.size(), SimDiagnostics(), [&](size_t begin, size_t end) {
+            SimDiagnostics partial;
+            for (size_t s = begin; s < end; s++) {
+                const Spring& spring = m_springs[s];
+                glm::vec3 e = q[spring.b] - q[spring.a];
+                float length = glm::length(e);
+                m_projections[s] = length > 0.0f ? e * (spring.restLength / length) : glm::vec3(0.0f);
+                partial.AddSpring(spring.weight, length - spring.restLength, spring.restLength);
+            }
+            return partial;
+        }, [](SimDiagnostics a, const SimDiagnostics& b) { a.Add(b); return a; }, 4096);
+        if (diagnostics && iteration + 1 == iterations) {
+            diagnostics->elasticEnergy = springs.elasticEnergy;
+            diagnostics->maxStrain = springs.maxStrain;
+        }
+
+        // 3. Global step: right-hand side M / h^2 y + J d, then the two triangular solves
+        // (or a few PCG iterations from the current iterate)
+        for (size_t i = 0; i < count; i++) {
+            b[i] = m_factorPinned[i] ? particles[i]->position : particles[i]->mass * invH2 * m_inertial[i];
+        }
+        for (size_t s = 0; s < m_springs.size(); s++) {
+            const Spring& spring = m_springs[s];
+            glm::vec3 d = spring.weight * m_projections[s];
+            bool freeA = !m_factorPinned[spring.a], freeB = !m_factorPinned[spring.b];
+            if (freeA) b[spring.a] -= d;
+            if (freeB) b[spring.b] += d;
+            // Coupling to a pinned partner: its (known) position moves to the right-hand side
+            if (freeA && !freeB) b[spring.a] += spring.weight * particles[spring.b]->position;
+            if (freeB && !freeA) b[spring.b] += spring.weight * particles[spring.a]->position;
+        }
+        if (m_factorMultigrid) {
+            m_lastSolveIterations = m_multigrid.SolvePCG(b.data(), q.data(), multigridIterations, multigridTolerance);
+        } else {
+            m_solver.Solve(b.data());
+            q.swap(b);
+        }
+    }
+
+    // 4. Velocities from the displacement
+    float invH = 1.0f / h;
+    for (size_t i = 0; i < count; i++) {
+        Particle& p = *particles[i];
+        if (p.isFixed) continue;
+        p.velocity = (q[i] - p.position) * invH;
+        p.position = q[i];
+    }
+}
@@ -0,0 +1,132 @@
+#include "RigidBody.h"
+#include "Particle.h"
+#include "Collider.h"
+
+RigidBody::RigidBody(glm::vec3 initialPosition, float bodyMass, const glm::mat3& inertiaBody) {
+    position = initialPosition;
+    orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    velocity = glm::vec3(0.0f);
+    angularMomentum = glm::vec3(0.0f);
+    angularVelocity = glm::vec3(0.0f);
+    forceAccumulator = glm::vec3(0.0f);
+    torqueAccumulator = glm::vec3(0.0f);
+    mass = bodyMass;
+    inverseInertiaBody = glm::inverse(inertiaBody);
+    isFixed = false;
+}
+
+void RigidBody::ApplyForce(const glm::vec3& force) {
+    forceAccumulator += force;
+}
+
+void RigidBody::ApplyForceAtPoint(const glm::vec3& force, const glm::vec3& worldPoint) {
+    forceAccumulator += force;
+    torqueAccumulator += glm::cross(worldPoint - position, force);
+}
+
+void RigidBody::ApplyImpulseAtPoint(const glm::vec3& impulse, const glm::vec3& worldPoint) {
+    velocity += impulse / mass;
+    angularMomentum += glm::cross(worldPoint - position, impulse);
+    angularVelocity = GetInverseInertiaWorld() * angularMomentum;
+}
+
+void RigidBody::ClearForces() {
+    forceAccumulator = glm::vec3(0.0f);
+    torqueAccumulator = glm::vec3(0.0f);
+}
+
+glm::mat3 RigidBody::GetInverseInertiaWorld() const {
+    glm::mat3 R = glm::mat3_cast(orientation);
+    return R * inverseInertiaBody * glm::transpose(R);
+}
+
+glm::vec3 RigidBody::GetPointPosition(size_t i) const {
+    return position + orientation * localPoints[i];
+}
+
+glm::vec3 RigidBody::GetVelocityAtPoint(const glm::vec3& worldPoint) const {
+    return velocity + glm::cross(angularVelocity, worldPoint - position);
+}
+
+void RigidBody::Update(float deltaTime) {
+    if (isFixed || mass <= 0.0f) {
+        return;
+    }
+
+    // 1. Update momenta FIRST (semi-implicit Euler)
+    velocity += (forceAccumulator / mass) * deltaTime;
+    angularMomentum += torqueAccumulator * deltaTime;
+
+    // 2. Angular velocity from the momentum with the current orientation.
+    // Integrating momentum instead of angular velocity avoids the explicit gyroscopic term.
+    angularVelocity = GetInverseInertiaWorld() * angularMomentum;
+
+    // 3. Update position and orientation SECOND using the new velocities
+    position += velocity * deltaTime;
+    glm::quat spin(0.0f, angularVelocity.x, angularVelocity.y, angularVelocity.z);
+    orientation = glm::normalize(orientation + (spin * orientation) * (0.5f * deltaTime));
+
+    angularVelocity = GetInverseInertiaWorld() * angularMomentum;
+}
+
+void RigidBody::ResolveContacts(const ColliderSet& colliders, float restitution, float friction) {
+    if (isFixed || colliders.colliders.empty()) return;
+
+    // 1. Distances and normals of every local point to the closest collider
+    thread_local std::vector<glm::vec3> points, normals;
+    thread_local std::vector<float> distances;
+    size_t count = localPoints.size();
+    points.resize(count);
+    normals.resize(count);
+    distances.resize(count);
+    for (size_t i = 0; i < count; i++) points[i] = GetPointPosition(i);
+    colliders.Query(points.data(), count, distances.data(), normals.data());
+
+    // 2. Lift the body out by the deepest penetration, along that point's normal
+    float deepest = 0.0f;
+    glm::vec3 liftNormal(0.0f, 1.0f, 0.0f);
+    for (size_t i = 0; i < count; i++) {
+        if (-distances[i] > deepest) {
+            deepest = -distances[i];
+            liftNormal = normals[i];
+        }
+    }
+    if (deepest <= 0.0f) return;
+    position += liftNormal * deepest;
+    for (size_t i = 0; i < count; i++) points[i] = GetPointPosition(i);
+    colliders.Query(points.data(), count, distances.data(), normals.data());
+
+    // 3. Normal and friction impulse at every touching point
+    for (size_t i = 0; i < count; i++) {
+        if (distances[i] > 0.001f) continue;
+        const glm::vec3& point = points[i];
+        const glm::vec3& n = normals[i];
+
+        glm::vec3 r = point - position;
+        glm::vec3 vContact = GetVelocityAtPoint(point);
+        float vn = glm::dot(vContact, n);
+        if (vn >= 0.0f) continue;
+
+        glm::mat3 invI = GetInverseInertiaWorld();
+        glm::vec3 rn = glm::cross(r, n);
+        float effective = 1.0f / mass + glm::dot(rn, invI * rn);
+        float jn = -(1.0f + restitution) * vn / effective;
+        ApplyImpulseAtPoint(n * jn, point);
+
+        // Coulomb friction opposing the sliding velocity, limited by the normal impulse
+        glm::vec3 vt = vContact - vn * n;
+        float vtLength = glm::length(vt);
+        if (vtLength > 0.0f) {
+            glm::vec3 t = vt / vtLength;
+            glm::vec3 rt = glm::cross(r, t);
+            float effectiveT = 1.0f / mass + glm::dot(rt, invI * rt);
+            float jt = glm::min(vtLength / effectiveT, friction * jn);
+            ApplyImpulseAtPoint(-t * jt, point);
+        }
+    }
+}
+
+void RigidBody::SyncAttachment(Particle& p, size_t i) const {
+    p.position = GetPointPosition(i);
+    p.velocity = GetVelocityAtPoint(p.position);
+}
@@ -0,0 +1,154 @@
+#include "RopeChains.h"
+#include "SimDiagnostics.h"
+#include <algorithm>
+
+RopeChains::RopeChains() {
+    iterations = 4;
+    errorCorrection = 1.0f;
+    maxCorrectionSpeed = 2.0f;
+}
+
+void RopeChains::Clear() {
+    m_chains.clear();
+    m_nodes.clear();
+    m_bodies.clear();
+}
+
+void RopeChains::Add(const std::vector<Particle*>& nodes, float restLength, RigidBody* endBody) {
+    if (nodes.size() < 2) return;
+    int body = -1;
+    if (endBody) {
+        for (size_t b = 0; b < m_bodies.size(); b++) {
+            if (m_bodies[b].body == endBody) body = (int)b;
+        }
+        if (body < 0) {
+            body = (int)m_bodies.size();
+            m_bodies.push_back({ endBody, glm::vec3(0.0f), glm::vec3(0.0f), glm::mat3(1.0f) });
+        }
+    }
+    m_chains.push_back({ m_nodes.size(), nodes.size(), restLength, body });
+    m_nodes.insert(m_nodes.end(), nodes.begin(), nodes.end());
+}
+
+void RopeChains::ApplyForces(float deltaTime, const glm::vec3& gravity, SimDiagnostics* diagnostics) {
+    if (m_chains.empty() || deltaTime <= 0.0f) return;
+    size_t n = m_nodes.size();
+    m_velocity.resize(n);
+    m_inverseMass.resize(n);
+    m_direction.resize(n);
+    m_bias.resize(n);
+    m_impulse.assign(n, 0.0f);
+
+    // 1. Velocities the bodies will have after the step without the ropes
+    for (BodyState& state : m_bodies) {
+        const RigidBody& body = *state.body;
+        state.velocity = body.velocity;
+        state.angularMomentum = body.angularMomentum;
+        state.inverseInertia = body.GetInverseInertiaWorld();
+        if (!body.isFixed && body.mass > 0.0f) {
+            state.velocity += (gravity + body.forceAccumulator / body.mass) * deltaTime;
+            state.angularMomentum += body.torqueAccumulator * deltaTime;
+        }
+    }
+
+    // 2. Same for the particles, and the links' directions and target stretch speeds
+    // (positions don't move during the solve, so the matrix only changes with the body states)
+    float maxSpeed = std::max(maxCorrectionSpeed, 0.0f);
+    for (const Chain& chain : m_chains) {
+        size_t last = chain.firstNode + chain.nodeCount - 1;
+        for (size_t k = chain.firstNode; k <= last; k++) {
+            const Particle& p = *m_nodes[k];
+            bool free = !p.isFixed && p.mass > 0.0f;
+            m_inverseMass[k] = free ? 1.0f / p.mass : 0.0f;
+            m_velocity[k] = free ? p.velocity + (p.forceAccumulator / p.mass) * deltaTime : p.velocity;
+            if (k == last) continue;
+
+            glm::vec3 d = m_nodes[k + 1]->position - p.position;
+            float length = glm::length(d);
+            m_direction[k] = length > 0.0f ? d / length : glm::vec3(0.0f, -1.0f, 0.0f);
+            float stretch = length - chain.restLength;
+            m_bias[k] = glm::clamp(-errorCorrection * stretch / deltaTime, -maxSpeed, maxSpeed);
+            if (diagnostics) diagnostics->AddSpring(0.0f, stretch, chain.restLength);
+        }
+    }
+
+    // 3. Exact per-chain solves, swept until the shared bodies agree
+    int sweeps = m_bodies.empty() ? 1 : std::max(iterations, 1);
+    for (int sweep = 0; sweep < sweeps; sweep++) {
+        for (const Chain& chain : m_chains) SolveChain(chain);
+    }
+
+    // 4. Hand the impulses to the integrators as forces over the step
+    for (const Chain& chain : m_chains) {
+        size_t last = chain.firstNode + chain.nodeCount - 1;
+        for (size_t k = chain.firstNode; k < last; k++) {
+            glm::vec3 force = m_direction[k] * (m_impulse[k] / deltaTime);
+            m_nodes[k]->ApplyForce(force);
+            m_nodes[k + 1]->ApplyForce(-force);
+        }
+    }
+}
+
+void RopeChains::SolveChain(const Chain& chain) {
+    size_t first = chain.firstNode, last = first + chain.nodeCount - 1;
+    size_t links = chain.nodeCount - 1;
+
+    // 1. A body end moves like the body's point, with its effective inverse mass along the last link
+    glm::vec3 arm(0.0f);
+    if (chain.body >= 0) {
+        const BodyState& state = m_bodies[chain.body];
+        const RigidBody& body = *state.body;
+        arm = m_nodes[last]->position - body.position;
+        glm::vec3 angularVelocity = state.inverseInertia * state.angularMomentum;
+        m_velocity[last] = state.velocity + glm::cross(angularVelocity, arm);
+        glm::vec3 rn = glm::cross(arm, m_direction[last - 1]);
+        m_inverseMass[last] = body.isFixed || body.mass <= 0.0f
+            ? 0.0f : 1.0f / body.mass + glm::dot(rn, state.inverseInertia * rn);
+    }
+
+    // 2. Tridiagonal system for the impulse increments (symmetric, so one off-diagonal)
+    m_diagonal.resize(links);
+    m_upper.resize(links);
+    m_rhs.resize(links);
+    for (size_t i = 0; i < links; i++) {
+        size_t k = first + i;
+        m_diagonal[i] = m_inverseMass[k] + m_inverseMass[k + 1];
+        m_upper[i] = i + 1 < links ? -m_inverseMass[k + 1] * glm::dot(m_direction[k], m_direction[k + 1]) : 0.0f;
+        m_rhs[i] = glm::dot(m_direction[k], m_velocity[k + 1] - m_velocity[k]) - m_bias[k];
+        // Both ends immovable: the link's row decouples (its off-diagonals are zero too)
+        if (m_diagonal[i] <= 0.0f) {
+            m_diagonal[i] = 1.0f;
+            m_rhs[i] = 0.0f;
+        }
+    }
+
+    // 3. Thomas algorithm: eliminate the lower diagonal, then back substitute.
+    // The matrix is diagonally dominant (|n_i.n_i+1| <= 1), so no pivoting is needed.
+    for (size_t i = 1; i < links; i++) {
+        float factor = m_upper[i - 1] / m_diagonal[i - 1];
+        m_diagonal[i] -= factor * m_upper[i - 1];
+        m_rhs[i] -= factor * m_rhs[i - 1];
+    }
+    m_rhs[links - 1] /= m_diagonal[links - 1];
+    for (size_t i = links - 1; i-- > 0;) {
+        m_rhs[i] = (m_rhs[i] - m_upper[i] * m_rhs[i + 1]) / m_diagonal[i];
+    }
+
+    // 4. Apply the increments to the predicted velocities (a body end to its body)
+    for (size_t i = 0; i < links; i++) {
+        size_t k = first + i;
+        float lambda = m_rhs[i];
+        m_impulse[k] += lambda;
+        m_velocity[k] += m_inverseMass[k] * lambda * m_direction[k];
+        if (k + 1 == last && chain.body >= 0) {
+            BodyState& state = m_bodies[chain.body];
+            const RigidBody& body = *state.body;
+            if (body.isFixed || body.mass <= 0.0f) continue;
+            glm::vec3 impulse = -lambda * m_direction[k];
+            state.velocity += impulse / body.mass;
+            state.angularMomentum += glm::cross(arm, impulse);
+        } else {
+            m_velocity[k + 1] -= m_inverseMass[k + 1] * lambda * m_direction[k];
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#include "SkylineCholesky.h"
+#include <algorithm> // For std::max
+#include <cmath>
+
+SkylineCholesky::SkylineCholesky() {
+    m_factored = false;
+}
+
+void SkylineCholesky::SetProfile(const std::vector<unsigned int>& firstColumn) {
+    m_firstColumn = firstColumn;
+    m_rowStart.resize(firstColumn.size() + 1);
+    m_rowStart[0] = 0;
+    for (size_t i = 0; i < firstColumn.size(); i++) {
+        m_rowStart[i + 1] = m_rowStart[i] + (i - firstColumn[i] + 1);
+    }
+    m_values.assign(m_rowStart.back(), 0.0);
+    m_work.resize(firstColumn.size());
+    m_factored = false;
+}
+
+void SkylineCholesky::Add(unsigned int row, unsigned int col, double value) {
+    m_values[RowBase(row) + col] += value;
+    m_factored = false;
+}
+
+bool SkylineCholesky::Factor() {
+    // Row by row: L(i, j) = (A(i, j) - sum_k L(i, k) L(j, k)) / L(j, j), where k only runs
+    // over the overlap of the two rows' profiles
+    unsigned int n = (unsigned int)Size();
+    double* v = m_values.data();
+    for (unsigned int i = 0; i < n; i++) {
+        size_t rowI = RowBase(i);
+        for (unsigned int j = m_firstColumn[i]; j <= i; j++) {
+            size_t rowJ = RowBase(j);
+            double sum = v[rowI + j];
+            for (unsigned int k = std::max(m_firstColumn[i], m_firstColumn[j]); k < j; k++) {
+                sum -= v[rowI + k] * v[rowJ + k];
+            }
+            if (j < i) {
+                v[rowI + j] = sum / v[rowJ + j];
+            } else {
+                if (sum <= 0.0) return false;
+                v[rowI + i] = std::sqrt(sum);
+            }
+        }
+    }
+    m_factored = true;
+    return true;
+}
+
+void SkylineCholesky::Solve(glm::vec3* b) const {
+    if (!m_factored) return;
+    unsigned int n = (unsigned int)Size();
+    const double* v = m_values.data();
+    glm::dvec3* x = m_work.data();
+
+    // 1. L y = b (forward substitution along each row)
+    for (unsigned int i = 0; i < n; i++) {
+        size_t row = RowBase(i);
+        glm::dvec3 sum = glm::dvec3(b[i]);
+        for (unsigned int k = m_firstColumn[i]; k < i; k++) sum -= v[row + k] * x[k];
+        x[i] = sum / v[row + i];
+    }
+
+    // 2. L^T x = y (back substitution, walking the rows of L as columns of L^T)
+    for (unsigned int i = n; i-- > 0;) {
+        size_t row = RowBase(i);
+        x[i] /= v[row + i];
+        for (unsigned int k = m_firstColumn[i]; k < i; k++) x[k] -= v[row + k] * x[i];
+    }
+
+    for (unsigned int i = 0; i < n; i++) b[i] = glm::vec3(x[i]);
+}
@@ -0,0 +1,94 @@
+#include "SparseMatrix.h"
+#include "ParallelFor.h"
+#include <algorithm> // For std::sort
+
+SparseMatrix::SparseMatrix() {
+    m_cols = 0;
+}
+
+void SparseMatrix::Build(size_t rows, size_t cols, const std::vector<Entry>& entries) {
+    std::vector<Entry> sorted = entries;
+    std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+
+    m_cols = cols;
+    m_rowStart.assign(rows + 1, 0);
+    m_columns.clear();
+    m_values.clear();
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const Entry& e = sorted[i];
+        // Merge duplicates into the previous entry of the same row
+        if (i > 0 && sorted[i - 1].row == e.row && sorted[i - 1].col == e.col) {
+            m_values.back() += (float)e.value;
+            continue;
+        }
+        m_columns.push_back(e.col);
+        m_values.push_back((float)e.value);
+        m_rowStart[e.row + 1]++;
+    }
+    for (size_t r = 0; r < rows; r++) m_rowStart[r + 1] += m_rowStart[r];
+}
+
+void SparseMatrix::Multiply(const glm::vec3* x, glm::vec3* y) const {
+    ParallelFor(0, Rows(), [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; r++) {
+            glm::vec3 sum(0.0f);
+            for (size_t e = m_rowStart[r]; e < m_rowStart[r + 1]; e++) sum += m_values[e] * x[m_columns[e]];
+            y[r] = sum;
+        }
+    }, 16384);
+}
+
+SparseMatrix SparseMatrix::Transpose() const {
+    std::vector<Entry> entries;
+    entries.reserve(NonZeros());
+    for (size_t r = 0; r < Rows(); r++) {
+        for (size_t e = m_rowStart[r]; e < m_rowStart[r + 1]; e++) {
+            entries.push_back({ m_columns[e], (unsigned int)r, m_values[e] });
+        }
+    }
+    SparseMatrix t;
+    t.Build(m_cols, Rows(), entries);
+    return t;
+}
+
+SparseMatrix SparseMatrix::Galerkin(const SparseMatrix& A, const SparseMatrix& P) {
+    // Row by row of P^T (Gustavson): coarse row I gathers P(r, I) A(r, c) P(c, J) in a dense
+    // accumulator, touching only the columns J that actually occur
+    SparseMatrix R = P.Transpose();
+    size_t coarse = P.Cols();
+    std::vector<double> accumulator(coarse, 0.0);
+    std::vector<unsigned char> used(coarse, 0);
+    std::vector<unsigned int> touched;
+    std::vector<Entry> entries;
+
+    for (size_t I = 0; I < coarse; I++) {
+        for (size_t re = R.m_rowStart[I]; re < R.m_rowStart[I + 1]; re++) {
+            unsigned int r = R.m_columns[re];
+            double pr = R.m_values[re];
+            for (size_t ae = A.m_rowStart[r]; ae < A.m_rowStart[r + 1]; ae++) {
+                unsigned int c = A.m_columns[ae];
+                double pa = pr * A.m_values[ae];
+                for (size_t pe = P.m_rowStart[c]; pe < P.m_rowStart[c + 1]; pe++) {
+                    unsigned int J = P.m_columns[pe];
+                    if (!used[J]) {
+                        used[J] = 1;
+                        touched.push_back(J);
+                    }
+                    accumulator[J] += pa * P.m_values[pe];
+                }
+            }
+        }
+        for (unsigned int J : touched) {
+            entries.push_back({ (unsigned int)I, J, accumulator[J] });
+            accumulator[J] = 0.0;
+            used[J] = 0;
+        }
+        touched.clear();
+    }
+
+    SparseMatrix result;
+    result.Build(coarse, coarse, entries);
+    return result;
+}
@@ -1,5 +1,6 @@
 #include "SpringDamper.h"
 #include "Particle.h"
+#include "SimDiagnostics.h"
 
 SpringDamper::SpringDamper(Particle* particle1, Particle* particle2, float ks, float kd, float initialLength) {
     p1 = particle1;
@@ -9,7 +10,7 @@ SpringDamper::SpringDamper(Particle* particle1, Particle* particle2, float ks, f
     restLength = initialLength;
 }
 
-void SpringDamper::ComputeForce() {
+void SpringDamper::ComputeForce(SimDiagnostics* diagnostics) {
     // Safety check
     if (!p1 || !p2) return;
 
@@ -36,4 +37,6 @@ void SpringDamper::ComputeForce() {
 
     p1->ApplyForce(f_total);
     p2->ApplyForce(-f_total);
+
+    if (diagnostics) diagnostics->AddSpring(springConstant, l - restLength, restLength);
 }
\ No newline at end of file
@@ -1,59 +1,47 @@
 #include "Triangle.h"
 #include "Particle.h"
-
-Triangle::Triangle(Particle* particle1, Particle* particle2, Particle* particle3) {
-    p1 = particle1;
-    p2 = particle2;
-    p3 = particle3;
+#include "WindField.h"
+
+glm::vec3 Triangle::ComputeDragPerParticle(const Particle& a, const Particle& b, const Particle& c, const glm::vec3& windVelocity,
+                                           float dragScale, glm::vec3& crossProduct) {
+    // 1. One cross product serves both the normal and the drag
+    crossProduct = glm::cross(b.position - a.position, c.position - a.position);
+
+    // 2. Drag without branches: zero relative velocity or zero area give zero force
+    glm::vec3 v_rel = (a.velocity + b.velocity + c.velocity) * (1.0f / 3.0f) - windVelocity;
+    float crossLength2 = glm::dot(crossProduct, crossProduct);
+    float invCrossLength = crossLength2 > 0.0f ? 1.0f / sqrt(crossLength2) : 0.0f;
+    float magnitude = -dragScale * glm::length(v_rel) * glm::dot(v_rel, crossProduct) * invCrossLength;
+    return magnitude * crossProduct;
 }
 
-void Triangle::ComputeNormal() {
-    // Calculate two edge vectors
-    glm::vec3 e1 = p2->position - p1->position;
-    glm::vec3 e2 = p3->position - p1->position;
-
-    // The cross product gives us a vector perpendicular to both edges (the face normal).
-    glm::vec3 crossProduct = glm::cross(e1, e2);
-
-    p1->normal += crossProduct;
-    p2->normal += crossProduct;
-    p3->normal += crossProduct;
+void Triangle::ComputeNormalAndAerodynamicForce(Particle& a, Particle& b, Particle& c, const glm::vec3& windVelocity, float dragScale,
+                                                bool accumulateNormals) {
+    glm::vec3 crossProduct;
+    glm::vec3 forcePerParticle = ComputeDragPerParticle(a, b, c, windVelocity, dragScale, crossProduct);
+    if (accumulateNormals) {
+        a.normal += crossProduct;
+        b.normal += crossProduct;
+        c.normal += crossProduct;
+    }
+    a.forceAccumulator += forcePerParticle;
+    b.forceAccumulator += forcePerParticle;
+    c.forceAccumulator += forcePerParticle;
 }
 
-void Triangle::ComputeAerodynamicForce(const glm::vec3& windVelocity, float airDensity, float dragCoefficient) {
-    // 1. Calculate the average velocity of the triangle's surface
-    glm::vec3 surfaceVelocity = (p1->velocity + p2->velocity + p3->velocity) / 3.0f;
-
-    // 2. Calculate the relative velocity between the triangle and the wind
-    glm::vec3 v_rel = surfaceVelocity - windVelocity;
-    float v_rel_length = glm::length(v_rel);
-
-    // If there is no relative motion, there is no drag
-    if (v_rel_length == 0.0f) return;
-
-    // 3. Calculate the normal and area
-    glm::vec3 e1 = p2->position - p1->position;
-    glm::vec3 e2 = p3->position - p1->position;
-    glm::vec3 crossProduct = glm::cross(e1, e2);
-
-    // Area of triangle is half the magnitude of the cross product
-    float area = glm::length(crossProduct) * 0.5f;
-
-    // Safety check for degenerate (zero-area) triangles
-    if (area == 0.0f) return;
-
-    glm::vec3 normal = glm::normalize(crossProduct); // Normalized normal
-    // 4. Calculate the aerodynamic drag force
-    // We use the dot product to find how much the triangle is facing the wind
-    float dotProduct = glm::dot(v_rel, normal);
-    float forceMagnitude = -0.5f * airDensity * (v_rel_length * v_rel_length) * dragCoefficient * area * (dotProduct / v_rel_length);
-
-    glm::vec3 aeroForce = forceMagnitude * normal;
-    // 5. Distribute the total aerodynamic force equally among the three vertices
-    glm::vec3 forcePerParticle = aeroForce / 3.0f;
-
-    p1->ApplyForce(forcePerParticle);
-    p2->ApplyForce(forcePerParticle);
-    p3->ApplyForce(forcePerParticle);
-
-}
\ No newline at end of file
+void Triangle::ComputeNormalsAndAerodynamics(Particle* const* particles, const unsigned int* indices, size_t triangleCount,
+                                             const glm::vec3& windVelocity, float airDensity, float dragCoefficient,
+                                             const WindField* windField, bool accumulateNormals) {
+    float dragScale = airDensity * dragCoefficient / 12.0f;
+    for (size_t t = 0; t < triangleCount; t++) {
+        Particle& a = *particles[indices[3 * t]];
+        Particle& b = *particles[indices[3 * t + 1]];
+        Particle& c = *particles[indices[3 * t + 2]];
+
+        // Sample the wind field at the triangle centroid
+        glm::vec3 wind = windVelocity;
+        if (windField) wind += windField->Sample((a.position + b.position + c.position) / 3.0f);
+
+        ComputeNormalAndAerodynamicForce(a, b, c, wind, dragScale, accumulateNormals);
+    }
+}
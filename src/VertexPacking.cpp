@@ -0,0 +1,150 @@
+#include "VertexPacking.h"
+#include "Particle.h"
+#include <glad/glad.h>
+#include <algorithm> // For std::min, std::max
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VERTEX_PACKING_SSE2 1
+#endif
+
+// Uniform access to both particle storages
+static const Particle& ParticleAt(const Particle* particles, size_t i) { return particles[i]; }
+static const Particle& ParticleAt(const Particle* const* particles, size_t i) { return *particles[i]; }
+
+template <typename Particles>
+static PackedBounds ComputeBounds(Particles particles, size_t count) {
+    if (count == 0) return { glm::vec3(0.0f), glm::vec3(1.0f) };
+    glm::vec3 lo = ParticleAt(particles, 0).position, hi = lo;
+    for (size_t i = 1; i < count; i++) {
+        lo = glm::min(lo, ParticleAt(particles, i).position);
+        hi = glm::max(hi, ParticleAt(particles, i).position);
+    }
+    // A flat axis still needs a non-zero extent to divide by
+    return { lo, glm::max(hi - lo, glm::vec3(1e-6f)) };
+}
+
+static void PackScalar(const glm::vec3& position, const glm::vec3& normal, const glm::vec3& boundsMin, const glm::vec3& scale,
+                       PackedVertex& out) {
+    // 1. Position: unorm16 inside the box
+    glm::vec3 q = glm::clamp((position - boundsMin) * scale + 0.5f, glm::vec3(0.0f), glm::vec3(65535.0f));
+    out.position[0] = (uint16_t)q.x;
+    out.position[1] = (uint16_t)q.y;
+    out.position[2] = (uint16_t)q.z;
+
+    // 2. Normal: project onto the octahedron |x| + |y| + |z| = 1, fold the lower half over
+    float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    float inv = l1 > 0.0f ? 1.0f / l1 : 0.0f;
+    float u = normal.x * inv, v = normal.y * inv;
+    if (normal.z < 0.0f) {
+        float fu = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float fv = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = fu;
+        v = fv;
+    }
+    out.normal[0] = (int8_t)std::lrint(u * 127.0f);
+    out.normal[1] = (int8_t)std::lrint(v * 127.0f);
+}
+
+template <typename Particles>
+static void Pack(Particles particles, size_t count, const PackedBounds& bounds, PackedVertex* out) {
+    glm::vec3 scale = 65535.0f / bounds.extent;
+    size_t i = 0;
+
+#ifdef VERTEX_PACKING_SSE2
+    // Four vertices per iteration, one lane each
+    const __m128 minX = _mm_set1_ps(bounds.min.x), minY = _mm_set1_ps(bounds.min.y), minZ = _mm_set1_ps(bounds.min.z);
+    const __m128 scaleX = _mm_set1_ps(scale.x), scaleY = _mm_set1_ps(scale.y), scaleZ = _mm_set1_ps(scale.z);
+    const __m128 half = _mm_set1_ps(0.5f), zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 maxUnorm = _mm_set1_ps(65535.0f), snormScale = _mm_set1_ps(127.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128i bias = _mm_set1_epi32(32768), unbias = _mm_set1_epi16((short)0x8000);
+
+    for (; i + 4 <= count; i += 4) {
+        const Particle& p0 = ParticleAt(particles, i);
+        const Particle& p1 = ParticleAt(particles, i + 1);
+        const Particle& p2 = ParticleAt(particles, i + 2);
+        const Particle& p3 = ParticleAt(particles, i + 3);
+        __m128 x = _mm_set_ps(p3.position.x, p2.position.x, p1.position.x, p0.position.x);
+        __m128 y = _mm_set_ps(p3.position.y, p2.position.y, p1.position.y, p0.position.y);
+        __m128 z = _mm_set_ps(p3.position.z, p2.position.z, p1.position.z, p0.position.z);
+        __m128 nx = _mm_set_ps(p3.normal.x, p2.normal.x, p1.normal.x, p0.normal.x);
+        __m128 ny = _mm_set_ps(p3.normal.y, p2.normal.y, p1.normal.y, p0.normal.y);
+        __m128 nz = _mm_set_ps(p3.normal.z, p2.normal.z, p1.normal.z, p0.normal.z);
+
+        // 1. Positions. SSE2 only packs with signed saturation, so shift to [-32768, 32767]
+        // before packing and flip the top bit back afterwards.
+        auto quantize = [&](__m128 v, __m128 lo, __m128 s) {
+            __m128 q = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(v, lo), s), half);
+            q = _mm_min_ps(_mm_max_ps(q, zero), maxUnorm);
+            __m128i shifted = _mm_sub_epi32(_mm_cvttps_epi32(q), bias);
+            return _mm_xor_si128(_mm_packs_epi32(shifted, shifted), unbias);
+        };
+        alignas(16) uint16_t qx[8], qy[8], qz[8];
+        _mm_store_si128((__m128i*)qx, quantize(x, minX, scaleX));
+        _mm_store_si128((__m128i*)qy, quantize(y, minY, scaleY));
+        _mm_store_si128((__m128i*)qz, quantize(z, minZ, scaleZ));
+
+        // 2. Octahedral normals, the lower half folded without branches
+        __m128 absX = _mm_andnot_ps(signMask, nx), absY = _mm_andnot_ps(signMask, ny), absZ = _mm_andnot_ps(signMask, nz);
+        __m128 l1 = _mm_add_ps(_mm_add_ps(absX, absY), absZ);
+        __m128 inv = _mm_and_ps(_mm_cmpgt_ps(l1, zero), _mm_div_ps(one, l1));
+        __m128 u = _mm_mul_ps(nx, inv), v = _mm_mul_ps(ny, inv);
+        __m128 signU = _mm_or_ps(_mm_and_ps(u, signMask), one);
+        __m128 signV = _mm_or_ps(_mm_and_ps(v, signMask), one);
+        __m128 foldU = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, v)), signU);
+        __m128 foldV = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, u)), signV);
+        __m128 lower = _mm_cmplt_ps(nz, zero);
+        u = _mm_or_ps(_mm_and_ps(lower, foldU), _mm_andnot_ps(lower, u));
+        v = _mm_or_ps(_mm_and_ps(lower, foldV), _mm_andnot_ps(lower, v));
+        __m128i iu = _mm_cvtps_epi32(_mm_mul_ps(u, snormScale));
+        __m128i iv = _mm_cvtps_epi32(_mm_mul_ps(v, snormScale));
+        __m128i uv16 = _mm_packs_epi32(iu, iv);  // u0..u3, v0..v3
+        alignas(16) int8_t uv[16];
+        _mm_store_si128((__m128i*)uv, _mm_packs_epi16(uv16, uv16));
+
+        for (int k = 0; k < 4; k++) {
+            PackedVertex& o = out[i + k];
+            o.position[0] = qx[k];
+            o.position[1] = qy[k];
+            o.position[2] = qz[k];
+            o.normal[0] = uv[k];
+            o.normal[1] = uv[4 + k];
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        const Particle& p = ParticleAt(particles, i);
+        PackScalar(p.position, p.normal, bounds.min, scale, out[i]);
+    }
+}
+
+PackedBounds ComputePackedBounds(const Particle* particles, size_t count) { return ComputeBounds(particles, count); }
+PackedBounds ComputePackedBounds(const Particle* const* particles, size_t count) { return ComputeBounds(particles, count); }
+
+void PackVertices(const Particle* particles, size_t count, const PackedBounds& bounds, PackedVertex* out) {
+    Pack(particles, count, bounds, out);
+}
+
+void PackVertices(const Particle* const* particles, size_t count, const PackedBounds& bounds, PackedVertex* out) {
+    Pack(particles, count, bounds, out);
+}
+
+void SetVertexAttributes(bool packed) {
+    if (packed) {
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+        glVertexAttribPointer(1, 2, GL_BYTE, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+    } else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    }
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+}
+
+void SetPackedBoundsUniforms(unsigned int shaderProgram, const PackedBounds& bounds) {
+    glUniform3fv(glGetUniformLocation(shaderProgram, "boundsMin"), 1, &bounds.min[0]);
+    glUniform3fv(glGetUniformLocation(shaderProgram, "boundsExtent"), 1, &bounds.extent[0]);
+}
@@ -0,0 +1,118 @@
+#include "WindField.h"
+#include "ParallelFor.h"
+#include <glm/gtc/noise.hpp>
+#include <fstream>
+#include <iostream>
+
+WindField::WindField(glm::vec3 minCorner, glm::vec3 maxCorner, float cellSize) {
+    this->cellSize = cellSize;
+    origin = minCorner;
+    resolution = glm::max(glm::ivec3(glm::ceil((maxCorner - minCorner) / cellSize)) + glm::ivec3(1), glm::ivec3(2));
+    velocities.assign((size_t)resolution.x * resolution.y * resolution.z, glm::vec3(0.0f));
+
+    turbulenceStrength = 0.0f;
+    noiseScale = 0.08f;
+    timeScale = 0.2f;
+    updateInterval = 0.1f; // 10 Hz, against hundreds of physics steps per second
+
+    m_time = 0.0f;
+    m_sinceUpdate = 0.0f;
+    m_procedural = true;
+}
+
+void WindField::GenerateCurlNoise(float time) {
+    // 1. Vector potential from three decorrelated noise channels.
+    // Each channel scrolls through 3D noise over time (about 3x cheaper than 4D noise).
+    std::vector<glm::vec3> potential(velocities.size());
+    float t = time * timeScale;
+    ParallelFor(0, resolution.z, [&](size_t zBegin, size_t zEnd) {
+        for (int z = (int)zBegin; z < (int)zEnd; z++) {
+            for (int y = 0; y < resolution.y; y++) {
+                for (int x = 0; x < resolution.x; x++) {
+                    glm::vec3 p = (origin + glm::vec3(x, y, z) * cellSize) * noiseScale;
+                    potential[Index(x, y, z)] = glm::vec3(
+                        glm::perlin(p + glm::vec3(t)),
+                        glm::perlin(p + glm::vec3(31.4f, 17.3f + t, 5.9f)),
+                        glm::perlin(p + glm::vec3(-11.7f - t, 43.1f, 23.5f))
+                    );
+                }
+            }
+        }
+    });
+
+    // 2. Velocity = curl(potential) by finite differences (one-sided at the borders)
+    float scale = turbulenceStrength / (noiseScale * cellSize);
+    ParallelFor(0, resolution.z, [&](size_t zBegin, size_t zEnd) {
+        for (int z = (int)zBegin; z < (int)zEnd; z++) {
+            int z0 = glm::max(z - 1, 0), z1 = glm::min(z + 1, resolution.z - 1);
+            for (int y = 0; y < resolution.y; y++) {
+                int y0 = glm::max(y - 1, 0), y1 = glm::min(y + 1, resolution.y - 1);
+                for (int x = 0; x < resolution.x; x++) {
+                    int x0 = glm::max(x - 1, 0), x1 = glm::min(x + 1, resolution.x - 1);
+                    glm::vec3 dx = (potential[Index(x1, y, z)] - potential[Index(x0, y, z)]) / float(x1 - x0);
+                    glm::vec3 dy = (potential[Index(x, y1, z)] - potential[Index(x, y0, z)]) / float(y1 - y0);
+                    glm::vec3 dz = (potential[Index(x, y, z1)] - potential[Index(x, y, z0)]) / float(z1 - z0);
+                    velocities[Index(x, y, z)] = glm::vec3(
+                        dy.z - dz.y,
+                        dz.x - dx.z,
+                        dx.y - dy.x
+                    ) * scale;
+                }
+            }
+        }
+    });
+}
+
+bool WindField::LoadFromFile(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "ERROR::WINDFIELD::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+        return false;
+    }
+
+    glm::ivec3 res;
+    glm::vec3 org;
+    float cell;
+    file >> res.x >> res.y >> res.z >> org.x >> org.y >> org.z >> cell;
+    if (!file || res.x < 2 || res.y < 2 || res.z < 2 || cell <= 0.0f) {
+        std::cout << "ERROR::WINDFIELD::BAD_HEADER " << path << std::endl;
+        return false;
+    }
+
+    std::vector<glm::vec3> data((size_t)res.x * res.y * res.z);
+    for (glm::vec3& v : data) {
+        file >> v.x >> v.y >> v.z;
+    }
+    if (!file) {
+        std::cout << "ERROR::WINDFIELD::TRUNCATED " << path << std::endl;
+        return false;
+    }
+
+    resolution = res;
+    origin = org;
+    cellSize = cell;
+    velocities.swap(data);
+    m_procedural = false;
+    return true;
+}
+
+void WindField::Update(float deltaTime) {
+    m_time += deltaTime;
+    m_sinceUpdate += deltaTime;
+    if (!m_procedural || m_sinceUpdate < updateInterval) return;
+
+    m_sinceUpdate = 0.0f;
+    GenerateCurlNoise(m_time);
+}
+
+glm::vec3 WindField::Sample(const glm::vec3& p) const {
+    glm::vec3 g = glm::clamp((p - origin) / cellSize, glm::vec3(0.0f), glm::vec3(resolution - glm::ivec3(1)));
+    glm::ivec3 i0 = glm::min(glm::ivec3(g), resolution - glm::ivec3(2));
+    glm::vec3 f = g - glm::vec3(i0);
+
+    glm::vec3 c00 = glm::mix(velocities[Index(i0.x, i0.y,     i0.z)],     velocities[Index(i0.x + 1, i0.y,     i0.z)],     f.x);
+    glm::vec3 c10 = glm::mix(velocities[Index(i0.x, i0.y + 1, i0.z)],     velocities[Index(i0.x + 1, i0.y + 1, i0.z)],     f.x);
+    glm::vec3 c01 = glm::mix(velocities[Index(i0.x, i0.y,     i0.z + 1)], velocities[Index(i0.x + 1, i0.y,     i0.z + 1)], f.x);
+    glm::vec3 c11 = glm::mix(velocities[Index(i0.x, i0.y + 1, i0.z + 1)], velocities[Index(i0.x + 1, i0.y + 1, i0.z + 1)], f.x);
+    return glm::mix(glm::mix(c00, c10, f.y), glm::mix(c01, c11, f.y), f.z);
+}
@@ -0,0 +1,1430 @@
+#include "World.h"
+#include "Triangle.h"
+#include "ParallelFor.h"
+#include <glm/gtc/constants.hpp> // For glm::root_two
+#include <algorithm> // For std::sort
+
+// Grid spring constants (same as Cloth::InitCloth), shared by BuildGrid and the LOD twins
+static const float kStructuralKs = 450.0f, kShearKs = 100.0f, kBendKs = 200.0f, kGridKd = 0.5f;
+// Smallest nonzero tear threshold: lower ones break springs at (or near) rest length
+static const float kMinTearStretch = 1.05f;
+
+World::World() {
+    VAO = VBO = EBO = 0;
+    lineVAO = lineEBO = 0;
+    previousVBO = 0;
+    interpolate = false;
+    quantizedVertices = false;
+    m_vaoPacked = false;
+    colliders = ColliderSet::Ground();
+    windField = nullptr;
+    maxTearsPerStep = 32;
+    gatherForces = false;
+    simulationLod = false;
+    lodDistances[0] = 25.0f;
+    lodDistances[1] = 50.0f;
+    lodHysteresis = 0.1f;
+    adaptiveRemesh = false;
+    refineAngle = 0.5f;
+    coarsenAngle = 0.2f;
+    refineStrainWeight = 1.0f;
+    minEdgeLength = 0.1f;
+    remeshInterval = 10;
+    maxRefinedParticles = 512;
+    m_stepsSinceRemesh = 0;
+    m_adjacencyDirty = true;
+    m_tearStretch = 0.0f;
+    m_meshDirty = true;
+    m_vboCapacity = 0;
+}
+
+World::~World() {
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteVertexArrays(1, &lineVAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        glDeleteBuffers(1, &lineEBO);
+        glDeleteBuffers(1, &previousVBO);
+    }
+}
+
+unsigned int World::BeginBody(BodyType type) {
+    WorldBody b;
+    b.type = type;
+    b.firstParticle = (unsigned int)particles.size();
+    b.firstSpring = (unsigned int)springs.size();
+    b.firstTriangle = (unsigned int)triangles.size();
+    b.particleCount = b.springCount = b.triangleCount = 0;
+    b.dragCoefficient = 0.0f;
+    b.selfCollisionRadius = 0.0f;
+    b.kRepel = 0.0f;
+    b.velocityDamping = 1.0f;
+    b.maxAcceleration = 0.0f;
+    b.groundOffset = 0.0f;
+    b.groundRestitution = 0.3f;
+    b.groundFriction = 0.8f;
+    b.tearStretch = 0.0f;
+    b.color = glm::vec3(0.5f);
+    b.rigidBody = -1;
+    b.parachute = -1;
+    b.gridWidth = b.gridHeight = 0;
+    b.gridSpacing = 0.0f;
+    b.simulated = true;
+    b.lod = -1;
+    b.lodTwin = false;
+    b.splitCount = 0;
+    bodies.push_back(b);
+    return (unsigned int)bodies.size() - 1;
+}
+
+void World::EndBody(unsigned int body) {
+    WorldBody& b = bodies[body];
+    b.particleCount = (unsigned int)particles.size() - b.firstParticle;
+    b.springCount = (unsigned int)springs.size() - b.firstSpring;
+    b.triangleCount = (unsigned int)triangles.size() - b.firstTriangle;
+    m_meshDirty = true;
+    m_adjacencyDirty = true;
+}
+
+unsigned int World::AddParticle(glm::vec3 position, float mass) {
+    particles.emplace_back(position, mass);
+    particleBody.push_back((unsigned int)bodies.size() - 1);
+    return (unsigned int)particles.size() - 1;
+}
+
+void World::AddSpring(unsigned int p1, unsigned int p2, float ks, float kd, float restLength) {
+    springs.push_back({ p1, p2, ks, kd, restLength, true });
+}
+
+void World::BuildGrid(glm::vec3 origin, int width, int height, float spacing, float totalMass) {
+    // Same layout and stiffness as Cloth::InitCloth, offset by origin
+    float ksStruct = kStructuralKs, kdStruct = kGridKd;
+    float ksShear  = kShearKs,      kdShear  = kGridKd;
+    float ksBend   = kBendKs,       kdBend   = kGridKd;
+
+    float particleMass = totalMass / (width * height);
+    unsigned int base = (unsigned int)particles.size();
+    unsigned int body = (unsigned int)bodies.size() - 1;
+
+    // 1. GENERATE PARTICLES
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            glm::vec3 pos(
+                (x - width / 2.0f) * spacing,
+                -y * spacing,
+                sin(x * 0.5f) * 0.1f
+            );
+            unsigned int i = AddParticle(origin + pos, particleMass);
+            if (y == 0) particles[i].isFixed = true;
+        }
+    }
+    auto Idx = [&](int x, int y) -> unsigned int {
+        return base + y * width + x;
+    };
+    // 2. GENERATE SPRINGS
+    float shearDist = glm::root_two<float>() * spacing;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned int p = Idx(x, y);
+            if (x < width - 1) AddSpring(p, Idx(x + 1, y), ksStruct, kdStruct, spacing);
+            if (y < height - 1) AddSpring(p, Idx(x, y + 1), ksStruct, kdStruct, spacing);
+            if (x < width - 1 && y < height - 1) {
+                AddSpring(p, Idx(x + 1, y + 1), ksShear, kdShear, shearDist);
+                AddSpring(Idx(x + 1, y), Idx(x, y + 1), ksShear, kdShear, shearDist);
+            }
+            if (x < width - 2) AddSpring(p, Idx(x + 2, y), ksBend, kdBend, spacing * 2.0f);
+            if (y < height - 2) AddSpring(p, Idx(x, y + 2), ksBend, kdBend, spacing * 2.0f);
+        }
+    }
+    // 3. GENERATE TRIANGLES
+    for (int y = 0; y < height - 1; ++y) {
+        for (int x = 0; x < width - 1; ++x) {
+            triangles.push_back({ Idx(x, y), Idx(x, y + 1), Idx(x + 1, y), body, true });
+            triangles.push_back({ Idx(x + 1, y), Idx(x, y + 1), Idx(x + 1, y + 1), body, true });
+        }
+    }
+}
+
+void World::BuildCrate(glm::vec3 center, float size, float mass) {
+    // Same construction as Cube: a rigid body whose 8 corners are kinematic pool particles
+    float s = size / 2.0f;
+    unsigned int base = (unsigned int)particles.size();
+    unsigned int body = (unsigned int)bodies.size() - 1;
+
+    RigidBody crate(center, mass, glm::mat3(mass * size * size / 6.0f));
+    crate.isFixed = true;
+    for (int z = 0; z < 2; z++) {
+        for (int y = 0; y < 2; y++) {
+            for (int x = 0; x < 2; x++) {
+                glm::vec3 local(x ? s : -s, y ? s : -s, z ? s : -s);
+                crate.localPoints.push_back(local);
+                unsigned int i = AddParticle(center + local, mass / 8.0f);
+                particles[i].isFixed = true;
+            }
+        }
+    }
+    rigidBodies.push_back(crate);
+    bodies[body].rigidBody = (int)rigidBodies.size() - 1;
+    // Faces use the same corner order as Cube (used for normals and rendering only)
+    static const unsigned int faces[36] = {
+        0, 2, 1,  1, 2, 3,
+        4, 5, 6,  5, 7, 6,
+        0, 4, 2,  2, 4, 6,
+        1, 3, 5,  3, 7, 5,
+        2, 6, 3,  3, 6, 7,
+        0, 1, 4,  1, 5, 4
+    };
+    for (int f = 0; f < 36; f += 3) {
+        triangles.push_back({ base + faces[f], base + faces[f + 1], base + faces[f + 2], body, true });
+    }
+}
+
+void World::BuildRopes(unsigned int canopy, unsigned int crate, int gridW, int gridH) {
+    // Same chains as ParachuteSystem::CreateRopes: canopy corner -> crate top corner
+    float ropeKs = 500.0f;
+    float ropeKd = 20.0f;
+    int segments = 8;
+    float ropeMassPerParticle = 0.1f;
+
+    unsigned int c = bodies[canopy].firstParticle;
+    unsigned int k = bodies[crate].firstParticle;
+    unsigned int clothCorners[4] = { c, c + gridW - 1, c + gridW * (gridH - 1), c + gridW * (gridH - 1) + gridW - 1 };
+    unsigned int crateCorners[4] = { k + 2, k + 3, k + 6, k + 7 };
+
+    for (int r = 0; r < 4; r++) {
+        glm::vec3 start = particles[clothCorners[r]].position;
+        glm::vec3 end = particles[crateCorners[r]].position;
+        float segmentLength = glm::distance(start, end) / segments;
+
+        unsigned int prev = clothCorners[r];
+        for (int i = 1; i < segments; i++) {
+            float t = (float)i / (float)segments;
+            unsigned int p = AddParticle(glm::mix(start, end, t), ropeMassPerParticle);
+            particles[p].isFixed = true;
+            AddSpring(prev, p, ropeKs, ropeKd, segmentLength);
+            prev = p;
+        }
+        AddSpring(prev, crateCorners[r], ropeKs, ropeKd, segmentLength);
+    }
+}
+
+unsigned int World::AddCloth(glm::vec3 origin, int width, int height, float spacing, float totalMass) {
+    m_scene.push_back({ false, origin, width, height, spacing, totalMass });
+
+    unsigned int body = BeginBody(BodyType::Cloth);
+    BuildGrid(origin, width, height, spacing, totalMass);
+    WorldBody& b = bodies[body];
+    b.dragCoefficient = 1.5f;
+    b.selfCollisionRadius = 0.3f;
+    b.kRepel = 2000.0f;
+    b.groundOffset = 0.05f;
+    b.groundRestitution = 0.2f;
+    b.tearStretch = m_tearStretch;
+    b.color = glm::vec3(0.55f, 0.15f, 0.15f);
+    b.gridWidth = width;
+    b.gridHeight = height;
+    b.gridSpacing = spacing;
+    EndBody(body);
+    return body;
+}
+
+unsigned int World::AddParachute(glm::vec3 dropPosition) {
+    m_scene.push_back({ true, dropPosition, 20, 20, 0.8f, 3.0f });
+
+    int gridW = 20, gridH = 20;
+    float spacing = 0.8f;
+    float maxAccel = 2000.0f;
+
+    // 1. Canopy: grid laid flat in the X-Z plane with a dome (same shape as ParachuteSystem)
+    unsigned int canopy = BeginBody(BodyType::Cloth);
+    BuildGrid(dropPosition, gridW, gridH, spacing, 3.0f);
+    unsigned int c = bodies[canopy].firstParticle;
+    for (int gy = 0; gy < gridH; gy++) {
+        for (int gx = 0; gx < gridW; gx++) {
+            Particle& p = particles[c + gy * gridW + gx];
+            float dx = (gx - (gridW - 1) / 2.0f) * spacing;
+            float dz = (gy - (gridH - 1) / 2.0f) * spacing;
+            float nx = (gx - (gridW - 1) / 2.0f) / ((gridW - 1) / 2.0f);
+            float nz = (gy - (gridH - 1) / 2.0f) / ((gridH - 1) / 2.0f);
+            float r2 = nx * nx + nz * nz;
+            float dome = (1.0f - glm::min(r2, 1.0f)) * 2.0f;
+            p.position = dropPosition + glm::vec3(dx, dome, dz);
+            p.isFixed = true;
+        }
+    }
+    // Reinforce corner particles at rope attachment points
+    float cornerMass = 0.5f;
+    particles[c].mass = cornerMass;
+    particles[c + gridW - 1].mass = cornerMass;
+    particles[c + gridW * (gridH - 1)].mass = cornerMass;
+    particles[c + gridW * (gridH - 1) + gridW - 1].mass = cornerMass;
+    // Stiffen canopy springs to hold the dome shape
+    for (size_t i = bodies[canopy].firstSpring; i < springs.size(); i++) {
+        springs[i].springConstant *= 3.0f;
+        springs[i].dampingFactor  *= 2.0f;
+    }
+    {
+        WorldBody& b = bodies[canopy];
+        b.dragCoefficient = 3.0f;
+        b.selfCollisionRadius = 0.35f;
+        b.maxAcceleration = maxAccel;
+        b.groundOffset = 0.05f;
+        b.tearStretch = m_tearStretch;
+        b.color = glm::vec3(0.15f, 0.55f, 0.15f);
+    }
+    EndBody(canopy);
+
+    // 2. Crate well below the canopy
+    unsigned int crate = BeginBody(BodyType::Crate);
+    BuildCrate(dropPosition - glm::vec3(0.0f, 12.0f, 0.0f), 2.0f, 10.0f);
+    bodies[crate].color = glm::vec3(0.55f, 0.35f, 0.15f);
+    EndBody(crate);
+
+    // 3. Rope chains between them
+    unsigned int ropes = BeginBody(BodyType::Rope);
+    BuildRopes(canopy, crate, gridW, gridH);
+    {
+        WorldBody& b = bodies[ropes];
+        b.velocityDamping = 0.995f;
+        b.maxAcceleration = maxAccel;
+        b.groundFriction = 0.0f;
+        b.color = glm::vec3(0.1f, 0.1f, 0.1f);
+    }
+    EndBody(ropes);
+
+    parachutes.push_back({ canopy, crate, ropes, 1.0f });
+    int chute = (int)parachutes.size() - 1;
+    bodies[canopy].parachute = bodies[crate].parachute = bodies[ropes].parachute = chute;
+    return (unsigned int)chute;
+}
+
+// Spring-damper force on s.p1 (s.p2 receives the negation)
+static glm::vec3 SpringForce(const PoolSpring& s, const Particle& p1, const Particle& p2) {
+    glm::vec3 e = p2.position - p1.position;
+    float l = glm::length(e);
+    if (l == 0.0f) return glm::vec3(0.0f);
+    glm::vec3 e_hat = e / l;
+    float v_rel_1D = glm::dot(p2.velocity - p1.velocity, e_hat);
+    return (s.springConstant * (l - s.restLength) + s.dampingFactor * v_rel_1D) * e_hat;
+}
+
+void World::BuildAdjacency() {
+    // Counting sort of the element endpoints by particle
+    size_t count = particles.size();
+    m_springOffsets.assign(count + 1, 0);
+    m_triangleOffsets.assign(count + 1, 0);
+    // Bodies standing in for each other at another level of detail are left out
+    for (const PoolSpring& s : springs) {
+        if (!s.active || !bodies[particleBody[s.p1]].simulated) continue;
+        m_springOffsets[s.p1 + 1]++;
+        m_springOffsets[s.p2 + 1]++;
+    }
+    for (const PoolTriangle& t : triangles) {
+        if (!t.active || !bodies[t.body].simulated) continue;
+        m_triangleOffsets[t.p1 + 1]++;
+        m_triangleOffsets[t.p2 + 1]++;
+        m_triangleOffsets[t.p3 + 1]++;
+    }
+    for (size_t i = 0; i < count; i++) {
+        m_springOffsets[i + 1] += m_springOffsets[i];
+        m_triangleOffsets[i + 1] += m_triangleOffsets[i];
+    }
+
+    // Fill in element order, so each particle sums its terms in a fixed order
+    m_particleSprings.resize(m_springOffsets[count]);
+    m_particleTriangles.resize(m_triangleOffsets[count]);
+    std::vector<unsigned int> springCursor(m_springOffsets.begin(), m_springOffsets.end() - 1);
+    std::vector<unsigned int> triangleCursor(m_triangleOffsets.begin(), m_triangleOffsets.end() - 1);
+    for (unsigned int i = 0; i < springs.size(); i++) {
+        const PoolSpring& s = springs[i];
+        if (!s.active || !bodies[particleBody[s.p1]].simulated) continue;
+        m_particleSprings[springCursor[s.p1]++] = i;
+        m_particleSprings[springCursor[s.p2]++] = i;
+    }
+    for (unsigned int i = 0; i < triangles.size(); i++) {
+        const PoolTriangle& t = triangles[i];
+        if (!t.active || !bodies[t.body].simulated) continue;
+        m_particleTriangles[triangleCursor[t.p1]++] = i;
+        m_particleTriangles[triangleCursor[t.p2]++] = i;
+        m_particleTriangles[triangleCursor[t.p3]++] = i;
+    }
+    m_adjacencyDirty = false;
+}
+
+void World::GatherForces(const glm::vec3& gravity, const glm::vec3& windVelocity, float airDensity) {
+    // Reads any particle, writes only particle i. A particle's gather is a dozen springs and
+    // six triangles, so below a couple of thousand particles per thread waking the workers
+    // (paid on every substep) costs more than it saves and the loop stays serial.
+    ParallelFor(0, particles.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            glm::vec3 force = gravity * particles[i].mass;
+            glm::vec3 normal(0.0f);
+
+            for (unsigned int k = m_springOffsets[i]; k < m_springOffsets[i + 1]; k++) {
+                const PoolSpring& s = springs[m_particleSprings[k]];
+                glm::vec3 f_total = SpringForce(s, particles[s.p1], particles[s.p2]);
+                force += s.p1 == i ? f_total : -f_total;
+            }
+
+            for (unsigned int k = m_triangleOffsets[i]; k < m_triangleOffsets[i + 1]; k++) {
+                const PoolTriangle& t = triangles[m_particleTriangles[k]];
+                const Particle& p1 = particles[t.p1];
+                const Particle& p2 = particles[t.p2];
+                const Particle& p3 = particles[t.p3];
+
+                glm::vec3 wind = windVelocity;
+                if (windField) wind += windField->Sample((p1.position + p2.position + p3.position) / 3.0f);
+                glm::vec3 crossProduct;
+                force += Triangle::ComputeDragPerParticle(p1, p2, p3, wind, airDensity * bodies[t.body].dragCoefficient / 12.0f, crossProduct);
+                normal += crossProduct;
+            }
+
+            Particle& p = particles[i];
+            p.normal = normal;
+            p.ClearForces();
+            p.ApplyForce(force);
+        }
+    }, 2048);
+}
+
+void World::UpdatePhysics(float deltaTime, const glm::vec3& windVelocity) {
+    glm::vec3 gravity(0.0f, -9.81f, 0.0f);
+    float airDensity = 1.225f;
+
+    if (gatherForces) {
+        // ===== PHASES 1-3 AS ONE PARALLEL GATHER OVER PARTICLES =====
+        if (m_adjacencyDirty) BuildAdjacency();
+        GatherForces(gravity, windVelocity, airDensity);
+    } else {
+        // ===== PHASE 1: RESET NORMALS, CLEAR FORCES, APPLY GRAVITY =====
+        for (Particle& p : particles) {
+            p.normal = glm::vec3(0.0f);
+            p.ClearForces();
+            p.ApplyForce(gravity * p.mass);
+        }
+
+        // ===== PHASE 2: ALL SPRINGS (cloth, crate and rope springs in one array) =====
+        for (const PoolSpring& s : springs) {
+            if (!s.active || !bodies[particleBody[s.p1]].simulated) continue;
+            glm::vec3 f_total = SpringForce(s, particles[s.p1], particles[s.p2]);
+            particles[s.p1].ApplyForce(f_total);
+            particles[s.p2].ApplyForce(-f_total);
+        }
+
+        // ===== PHASE 3: ALL TRIANGLES (normals and aerodynamics) =====
+        for (const PoolTriangle& t : triangles) {
+            if (!t.active || !bodies[t.body].simulated) continue;
+            Particle& p1 = particles[t.p1];
+            Particle& p2 = particles[t.p2];
+            Particle& p3 = particles[t.p3];
+
+            glm::vec3 wind = windVelocity;
+            if (windField) wind += windField->Sample((p1.position + p2.position + p3.position) / 3.0f);
+            Triangle::ComputeNormalAndAerodynamicForce(p1, p2, p3, wind, airDensity * bodies[t.body].dragCoefficient / 12.0f);
+        }
+    }
+
+    // ===== PHASE 4: SELF-COLLISION ACROSS ALL BODIES =====
+    // One sweep and prune over every collidable particle, so neighbouring flags collide too.
+    // Remeshing midpoints sit closer to their neighbours than the collision radius and are left out.
+    m_sorted.clear();
+    for (unsigned int i = 0; i < particles.size(); i++) {
+        if (particleBody[i] == kFreeSlot || (i < m_midpoints.size() && m_midpoints[i])) continue;
+        const WorldBody& b = bodies[particleBody[i]];
+        if (b.simulated && b.selfCollisionRadius > 0.0f) m_sorted.push_back(i);
+    }
+    std::sort(m_sorted.begin(), m_sorted.end(), [this](unsigned int a, unsigned int b) {
+        return particles[a].position.x < particles[b].position.x;
+    });
+    float maxRadius = 0.0f;
+    for (const WorldBody& b : bodies) maxRadius = glm::max(maxRadius, b.selfCollisionRadius);
+
+    for (size_t i = 0; i < m_sorted.size(); ++i) {
+        Particle& p1 = particles[m_sorted[i]];
+        const WorldBody& b1 = bodies[particleBody[m_sorted[i]]];
+        for (size_t j = i + 1; j < m_sorted.size(); ++j) {
+            Particle& p2 = particles[m_sorted[j]];
+            if (p2.position.x - p1.position.x > maxRadius) break;
+            if (p1.isFixed && p2.isFixed) continue;
+
+            const WorldBody& b2 = bodies[particleBody[m_sorted[j]]];
+            float radius = glm::max(b1.selfCollisionRadius, b2.selfCollisionRadius);
+            glm::vec3 diff = p1.position - p2.position;
+            float dist2 = glm::dot(diff, diff);
+            if (dist2 >= radius * radius || dist2 <= 0.00001f) continue;
+
+            float dist = sqrt(dist2);
+            glm::vec3 dir = diff / dist;
+            float overlap = radius - dist;
+
+            if (b1.kRepel > 0.0f && b2.kRepel > 0.0f) {
+                // Force-based repulsion (flags)
+                glm::vec3 force = dir * overlap * glm::min(b1.kRepel, b2.kRepel);
+                p1.ApplyForce(force);
+                p2.ApplyForce(-force);
+                continue;
+            }
+
+            // Position-based correction (canopies)
+            if (!p1.isFixed && !p2.isFixed) {
+                p1.position += dir * (overlap * 0.5f);
+                p2.position -= dir * (overlap * 0.5f);
+            } else if (!p1.isFixed) {
+                p1.position += dir * overlap;
+            } else {
+                p2.position -= dir * overlap;
+            }
+            float approach = glm::dot(p1.velocity - p2.velocity, dir);
+            if (approach < 0.0f) {
+                glm::vec3 impulse = dir * approach * 0.5f;
+                if (!p1.isFixed) p1.velocity -= impulse;
+                if (!p2.isFixed) p2.velocity += impulse;
+            }
+        }
+    }
+
+    // ===== PHASE 5: CANOPY/ROPE vs CRATE BOX COLLISION =====
+    // One oriented box per parachute from the crate pose. Particles torn off a canopy may
+    // live anywhere in the pool, so the pass walks the pool and looks up the box.
+    float margin = 0.15f;
+    m_crateColliders.resize(parachutes.size());
+    for (size_t c = 0; c < parachutes.size(); c++) {
+        const RigidBody& rb = rigidBodies[bodies[parachutes[c].crate].rigidBody];
+        m_crateColliders[c].Clear();
+        m_crateColliders[c].AddBox(rb.position, glm::vec3(parachutes[c].crateHalfSize + margin), glm::mat3_cast(rb.orientation));
+    }
+    for (size_t i = 0; i < particles.size(); i++) {
+        if (particleBody[i] == kFreeSlot) continue;
+        const WorldBody& b = bodies[particleBody[i]];
+        if (b.parachute < 0 || b.type == BodyType::Crate || particles[i].isFixed) continue;
+
+        float distance;
+        glm::vec3 normal;
+        m_crateColliders[b.parachute].Query(&particles[i].position, 1, &distance, &normal);
+        if (distance < 0.0f) {
+            // Push out to the nearest face and kill velocity into the box (slight bounce)
+            ColliderSet::Respond(particles[i], distance, normal, 0.0f, 0.1f, 0.0f);
+        }
+    }
+
+    // ===== PHASE 6: DAMPING, ACCELERATION CLAMP AND INTEGRATION =====
+    for (size_t i = 0; i < particles.size(); i++) {
+        if (particleBody[i] == kFreeSlot) continue;
+        Particle& p = particles[i];
+        const WorldBody& b = bodies[particleBody[i]];
+        if (!b.simulated) continue;
+
+        if (glm::length(p.normal) > 0.0f) {
+            p.normal = glm::normalize(p.normal);
+        } else {
+            p.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+
+        p.velocity *= b.velocityDamping;
+
+        if (b.maxAcceleration > 0.0f && !p.isFixed && p.mass > 0.0f) {
+            glm::vec3 accel = p.forceAccumulator / p.mass;
+            float accelMag = glm::length(accel);
+            if (accelMag > b.maxAcceleration) {
+                p.forceAccumulator = (accel / accelMag) * b.maxAcceleration * p.mass;
+            }
+        }
+
+        p.Update(deltaTime);
+    }
+
+    // ===== PHASE 7: GROUND AND OBSTACLES =====
+    // One batched query over the whole pool, then each particle responds with its body's settings
+    m_points.resize(particles.size());
+    m_distances.resize(particles.size());
+    m_normals.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); i++) {
+        m_points[i] = particles[i].position;
+    }
+    colliders.Query(m_points.data(), m_points.size(), m_distances.data(), m_normals.data());
+    for (size_t i = 0; i < particles.size(); i++) {
+        if (particleBody[i] == kFreeSlot || particles[i].isFixed) continue;
+        const WorldBody& b = bodies[particleBody[i]];
+        if (b.simulated && m_distances[i] < b.groundOffset) {
+            ColliderSet::Respond(particles[i], m_distances[i], m_normals[i], b.groundOffset, b.groundRestitution, b.groundFriction);
+        }
+    }
+
+    // ===== PHASE 8: RIGID BODIES =====
+    // Forces gathered on the kinematic corners (springs and the corners' share of
+    // gravity from phase 1) act on the body at that point
+    for (const WorldBody& b : bodies) {
+        if (b.rigidBody < 0) continue;
+        RigidBody& rb = rigidBodies[b.rigidBody];
+        for (unsigned int i = 0; i < b.particleCount; i++) {
+            const Particle& p = particles[b.firstParticle + i];
+            rb.ApplyForceAtPoint(p.forceAccumulator, p.position);
+        }
+        rb.Update(deltaTime);
+        rb.ResolveContacts(colliders, b.groundRestitution, b.groundFriction);
+        for (unsigned int i = 0; i < b.particleCount; i++) {
+            rb.SyncAttachment(particles[b.firstParticle + i], i);
+        }
+        rb.ClearForces();
+    }
+
+    // ===== PHASE 9: TEARING =====
+    TearSprings();
+
+    // ===== PHASE 10: ADAPTIVE REMESHING =====
+    if ((adaptiveRemesh || !m_splits.empty()) && ++m_stepsSinceRemesh >= remeshInterval) {
+        m_stepsSinceRemesh = 0;
+        Remesh(deltaTime);
+    }
+
+    // ===== PHASE 11: FLAGS AT A COARSER LEVEL OF DETAIL =====
+    for (const LodRecord& lod : m_lods) {
+        if (lod.level > 0) ReconstructFromTwin(lod);
+    }
+}
+
+void World::ReleaseParachutes() {
+    for (const WorldParachute& chute : parachutes) {
+        rigidBodies[bodies[chute.crate].rigidBody].isFixed = false;
+    }
+    for (size_t i = 0; i < particles.size(); i++) {
+        if (particleBody[i] == kFreeSlot) continue;
+        const WorldBody& b = bodies[particleBody[i]];
+        if (b.parachute >= 0 && b.rigidBody < 0) particles[i].isFixed = false;
+    }
+}
+
+void World::SetTearStretch(float stretch) {
+    // At or below 1 a spring would break at rest length (or under its own weight), which
+    // shreds every cloth: anything positive is raised to the smallest sensible threshold
+    if (stretch <= 0.0f) stretch = 0.0f;
+    else stretch = glm::max(stretch, kMinTearStretch);
+    m_tearStretch = stretch;
+    for (WorldBody& b : bodies) {
+        if (b.type == BodyType::Cloth && !b.lodTwin) b.tearStretch = stretch;
+    }
+}
+
+void World::Reset() {
+    std::vector<SceneItem> scene;
+    scene.swap(m_scene);
+
+    particles.clear();
+    particleBody.clear();
+    springs.clear();
+    triangles.clear();
+    rigidBodies.clear();
+    bodies.clear();
+    parachutes.clear();
+    m_lods.clear(); // Twins are rebuilt by the next UpdateLod
+    m_splits.clear();
+    m_midpoints.clear();
+    m_stepsSinceRemesh = 0;
+    m_freeParticles.clear();
+    m_freeSprings.clear();
+    m_freeTriangles.clear();
+    m_dirtyTriangles.clear();
+
+    // Rebuild from the stored scene description (builders re-record it)
+    for (const SceneItem& item : scene) {
+        if (item.isParachute) {
+            AddParachute(item.position);
+        } else {
+            AddCloth(item.position, item.width, item.height, item.spacing, item.totalMass);
+        }
+    }
+}
+
+void World::UpdateLod(const glm::vec3& cameraPosition) {
+    // 1. Twins for flags that don't have them yet (only built once LOD is first used)
+    if (simulationLod) {
+        for (unsigned int i = 0; i < bodies.size(); i++) {
+            if (bodies[i].lod < 0 && bodies[i].gridWidth >= 3 && bodies[i].gridHeight >= 3) BuildLodTwins(i);
+        }
+    }
+
+    // 2. Level from the distance between the camera and the flag's centre, with hysteresis
+    for (LodRecord& lod : m_lods) {
+        int level = 0;
+        if (simulationLod && !lod.torn && bodies[lod.fine].splitCount == 0) {
+            const WorldBody& b = bodies[lod.fine];
+            glm::vec3 center(0.0f);
+            for (unsigned int i = 0; i < b.particleCount; i++) center += particles[b.firstParticle + i].position;
+            float distance = glm::distance(center / (float)b.particleCount, cameraPosition);
+
+            level = lod.level;
+            while (level < 2 && distance > lodDistances[level] * (1.0f + lodHysteresis)) level++;
+            while (level > 0 && distance < lodDistances[level - 1] * (1.0f - lodHysteresis)) level--;
+        }
+        SetLodLevel(lod, level);
+    }
+}
+
+size_t World::SimulatedParticleCount() const {
+    size_t count = 0;
+    for (size_t i = 0; i < particles.size(); i++) {
+        if (particleBody[i] != kFreeSlot && bodies[particleBody[i]].simulated) count++;
+    }
+    return count;
+}
+
+void World::BuildLodTwins(unsigned int flag) {
+    LodRecord lod;
+    lod.fine = flag;
+    lod.level = 0;
+    lod.torn = false;
+    const WorldBody source = bodies[flag]; // Copy: adding the twins grows bodies
+    for (unsigned int i = source.firstSpring; i < source.firstSpring + source.springCount; i++) {
+        lod.torn |= !springs[i].active;
+    }
+    int index = (int)m_lods.size();
+    bodies[flag].lod = index;
+    if (lod.torn) {
+        // Torn before LOD was switched on: recorded so it isn't retried, but never coarsened
+        lod.twins[0] = lod.twins[1] = flag;
+        m_lods.push_back(lod);
+        return;
+    }
+
+    // Every factor-th grid line plus the last one, and for each fine line its segment
+    auto BuildAxis = [](int count, int factor, LodAxis& axis) {
+        for (int i = 0; i < count - 1; i += factor) axis.lines.push_back(i);
+        axis.lines.push_back(count - 1);
+        axis.cell.resize(count);
+        axis.t.resize(count);
+        unsigned int c = 0;
+        for (int i = 0; i < count; i++) {
+            while (c + 2 < axis.lines.size() && axis.lines[c + 1] <= (unsigned int)i) c++;
+            axis.cell[i] = c;
+            axis.t[i] = (float)(i - (int)axis.lines[c]) / (float)(axis.lines[c + 1] - axis.lines[c]);
+        }
+    };
+
+    const int factors[2] = { 2, 4 };
+    for (int k = 0; k < 2; k++) {
+        LodAxis& columns = lod.columns[k];
+        LodAxis& rows = lod.rows[k];
+        BuildAxis(source.gridWidth, factors[k], columns);
+        BuildAxis(source.gridHeight, factors[k], rows);
+        int width = (int)columns.lines.size(), height = (int)rows.lines.size();
+
+        // 1. Lump the flag's masses onto the twin with the interpolation weights (keeps the total)
+        std::vector<float> mass((size_t)width * height, 0.0f);
+        for (int y = 0; y < source.gridHeight; y++) {
+            for (int x = 0; x < source.gridWidth; x++) {
+                float m = particles[source.firstParticle + y * source.gridWidth + x].mass;
+                unsigned int c = rows.cell[y] * width + columns.cell[x];
+                float tx = columns.t[x], ty = rows.t[y];
+                mass[c]             += m * (1.0f - tx) * (1.0f - ty);
+                mass[c + 1]         += m * tx * (1.0f - ty);
+                mass[c + width]     += m * (1.0f - tx) * ty;
+                mass[c + width + 1] += m * tx * ty;
+            }
+        }
+
+        // 2. Particles on the kept grid lines
+        unsigned int twin = BeginBody(BodyType::Cloth);
+        unsigned int base = (unsigned int)particles.size();
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                Particle p = particles[source.firstParticle + rows.lines[y] * source.gridWidth + columns.lines[x]];
+                unsigned int i = AddParticle(p.position, mass[y * width + x]);
+                particles[i].velocity = p.velocity;
+                particles[i].isFixed = p.isFixed;
+            }
+        }
+
+        // 3. Same springs as BuildGrid. The in-plane stiffness of a spring lattice doesn't
+        // depend on its spacing, so structural and shear constants carry over; bending
+        // stiffness grows with the square of the spacing, so the bend springs are softened.
+        auto Idx = [&](int x, int y) -> unsigned int {
+            return base + y * width + x;
+        };
+        auto Rest = [&](int x0, int y0, int x1, int y1) {
+            float dx = (float)columns.lines[x1] - (float)columns.lines[x0];
+            float dy = (float)rows.lines[y1] - (float)rows.lines[y0];
+            return source.gridSpacing * sqrt(dx * dx + dy * dy);
+        };
+        float ksBend = kBendKs / (float)(factors[k] * factors[k]);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                unsigned int p = Idx(x, y);
+                if (x < width - 1) AddSpring(p, Idx(x + 1, y), kStructuralKs, kGridKd, Rest(x, y, x + 1, y));
+                if (y < height - 1) AddSpring(p, Idx(x, y + 1), kStructuralKs, kGridKd, Rest(x, y, x, y + 1));
+                if (x < width - 1 && y < height - 1) {
+                    AddSpring(p, Idx(x + 1, y + 1), kShearKs, kGridKd, Rest(x, y, x + 1, y + 1));
+                    AddSpring(Idx(x + 1, y), Idx(x, y + 1), kShearKs, kGridKd, Rest(x + 1, y, x, y + 1));
+                }
+                if (x < width - 2) AddSpring(p, Idx(x + 2, y), ksBend, kGridKd, Rest(x, y, x + 2, y));
+                if (y < height - 2) AddSpring(p, Idx(x, y + 2), ksBend, kGridKd, Rest(x, y, x, y + 2));
+            }
+        }
+        for (int y = 0; y < height - 1; ++y) {
+            for (int x = 0; x < width - 1; ++x) {
+                triangles.push_back({ Idx(x, y), Idx(x, y + 1), Idx(x + 1, y), twin, true });
+                triangles.push_back({ Idx(x + 1, y), Idx(x, y + 1), Idx(x + 1, y + 1), twin, true });
+            }
+        }
+
+        // 4. The flag's tuning (drag scales with area, so it carries over too), never torn
+        WorldBody& b = bodies[twin];
+        b.dragCoefficient = source.dragCoefficient;
+        b.selfCollisionRadius = source.selfCollisionRadius;
+        b.kRepel = source.kRepel;
+        b.velocityDamping = source.velocityDamping;
+        b.maxAcceleration = source.maxAcceleration;
+        b.groundOffset = source.groundOffset;
+        b.groundRestitution = source.groundRestitution;
+        b.groundFriction = source.groundFriction;
+        b.color = source.color;
+        b.simulated = false;
+        b.lod = index;
+        b.lodTwin = true;
+        EndBody(twin);
+        lod.twins[k] = twin;
+    }
+    m_lods.push_back(lod);
+}
+
+void World::SetLodLevel(LodRecord& lod, int level) {
+    if (level == lod.level) return;
+
+    // The flag's particles always hold the current state (simulated, or reconstructed after
+    // every step), so a twin starts from the flag's particles on its grid lines
+    if (level > 0) {
+        const WorldBody& flag = bodies[lod.fine];
+        const WorldBody& twin = bodies[lod.twins[level - 1]];
+        const LodAxis& columns = lod.columns[level - 1];
+        const LodAxis& rows = lod.rows[level - 1];
+        unsigned int i = twin.firstParticle;
+        for (unsigned int y : rows.lines) {
+            for (unsigned int x : columns.lines) {
+                const Particle& source = particles[flag.firstParticle + y * flag.gridWidth + x];
+                particles[i].position = source.position;
+                particles[i].velocity = source.velocity;
+                particles[i].isFixed = source.isFixed;
+                i++;
+            }
+        }
+    }
+
+    bodies[lod.fine].simulated = level == 0;
+    bodies[lod.twins[0]].simulated = level == 1;
+    bodies[lod.twins[1]].simulated = level == 2;
+    lod.level = level;
+    m_adjacencyDirty = true;
+}
+
+void World::ReconstructFromTwin(const LodRecord& lod) {
+    // Bilinear interpolation of the twin's grid; pinned particles of the flag stay put
+    const WorldBody& flag = bodies[lod.fine];
+    const WorldBody& twin = bodies[lod.twins[lod.level - 1]];
+    const LodAxis& columns = lod.columns[lod.level - 1];
+    const LodAxis& rows = lod.rows[lod.level - 1];
+    unsigned int twinWidth = (unsigned int)columns.lines.size();
+
+    for (int y = 0; y < flag.gridHeight; y++) {
+        float ty = rows.t[y];
+        unsigned int row = twin.firstParticle + rows.cell[y] * twinWidth;
+        for (int x = 0; x < flag.gridWidth; x++) {
+            Particle& p = particles[flag.firstParticle + y * flag.gridWidth + x];
+            if (p.isFixed) continue;
+            float tx = columns.t[x];
+            const Particle& a = particles[row + columns.cell[x]];
+            const Particle& b = particles[row + columns.cell[x] + 1];
+            const Particle& c = particles[row + columns.cell[x] + twinWidth];
+            const Particle& d = particles[row + columns.cell[x] + twinWidth + 1];
+            float wa = (1.0f - tx) * (1.0f - ty), wb = tx * (1.0f - ty);
+            float wc = (1.0f - tx) * ty, wd = tx * ty;
+
+            p.position = wa * a.position + wb * b.position + wc * c.position + wd * d.position;
+            p.velocity = wa * a.velocity + wb * b.velocity + wc * c.velocity + wd * d.velocity;
+            glm::vec3 normal = wa * a.normal + wb * b.normal + wc * c.normal + wd * d.normal;
+            p.normal = glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    }
+}
+
+static unsigned long long EdgeKey(unsigned int a, unsigned int b) {
+    return a < b ? (unsigned long long)a << 32 | b : (unsigned long long)b << 32 | a;
+}
+
+static glm::vec3 FaceNormal(const PoolTriangle& t, const std::vector<Particle>& particles) {
+    glm::vec3 n = glm::cross(particles[t.p2].position - particles[t.p1].position,
+                             particles[t.p3].position - particles[t.p1].position);
+    float length = glm::length(n);
+    return length > 0.0f ? n / length : glm::vec3(0.0f);
+}
+
+static float FaceAngle(const glm::vec3& n1, const glm::vec3& n2) {
+    return acos(glm::clamp(glm::dot(n1, n2), -1.0f, 1.0f));
+}
+
+bool World::RemeshEligible(const WorldBody& b) const {
+    // Flags only: canopies carry rope attachments, and tearing walks the body ranges
+    return b.type == BodyType::Cloth && b.parachute < 0 && !b.lodTwin && b.simulated && b.tearStretch <= 0.0f;
+}
+
+void World::Remesh(float deltaTime) {
+    // 1. Undo splits that flattened out (every split once remeshing is off). Newest first,
+    // so a split made inside another split's triangles is undone before it.
+    for (size_t i = m_splits.size(); i-- > 0;) {
+        const RemeshSplit& split = m_splits[i];
+        if (!SplitIntact(split)) continue;
+        if (adaptiveRemesh && RemeshEligible(bodies[split.body]) && SplitFold(split) >= coarsenAngle) continue;
+        UndoSplit(split);
+        m_splits.erase(m_splits.begin() + i);
+    }
+    if (!adaptiveRemesh) return;
+
+    // 2. Spring and adjacent triangles of every edge of the remeshed bodies
+    m_edgeSprings.clear();
+    m_edgeFaces.clear();
+    m_stiffness.assign(particles.size(), glm::vec2(0.0f));
+    for (unsigned int i = 0; i < springs.size(); i++) {
+        const PoolSpring& s = springs[i];
+        if (!s.active || particleBody[s.p1] != particleBody[s.p2] || !RemeshEligible(bodies[particleBody[s.p1]])) continue;
+        m_edgeSprings[EdgeKey(s.p1, s.p2)] = i;
+        m_stiffness[s.p1] += glm::vec2(s.springConstant, s.dampingFactor);
+        m_stiffness[s.p2] += glm::vec2(s.springConstant, s.dampingFactor);
+    }
+    m_restAreas.assign(particles.size(), 0.0f);
+    for (unsigned int i = 0; i < triangles.size(); i++) {
+        const PoolTriangle& t = triangles[i];
+        if (!t.active || !RemeshEligible(bodies[t.body])) continue;
+        const unsigned int corners[3] = { t.p1, t.p2, t.p3 };
+        float area = RestArea(t);
+        for (int k = 0; k < 3; k++) {
+            m_restAreas[corners[k]] += area;
+            EdgeFaces& edge = m_edgeFaces.emplace(EdgeKey(corners[k], corners[(k + 1) % 3]), EdgeFaces{ { 0, 0 }, 0 }).first->second;
+            if (edge.count < 2) edge.faces[edge.count] = i;
+            edge.count++;
+        }
+    }
+
+    // 3. Interior edges that fold (or stretch) past the threshold, worst first
+    m_remeshCandidates.clear();
+    for (const auto& entry : m_edgeFaces) {
+        if (entry.second.count != 2) continue;
+        auto spring = m_edgeSprings.find(entry.first);
+        if (spring == m_edgeSprings.end()) continue;
+        const PoolSpring& s = springs[spring->second];
+        if (s.restLength * 0.5f < minEdgeLength) continue;
+
+        float angle = FaceAngle(FaceNormal(triangles[entry.second.faces[0]], particles),
+                                FaceNormal(triangles[entry.second.faces[1]], particles));
+        float strain = std::abs(glm::distance(particles[s.p1].position, particles[s.p2].position) / s.restLength - 1.0f);
+        float score = angle + refineStrainWeight * strain;
+        if (score > refineAngle) m_remeshCandidates.push_back({ score, entry.first });
+    }
+    // Ties broken by the edge, so the result doesn't depend on the hash map's order
+    std::sort(m_remeshCandidates.begin(), m_remeshCandidates.end(), [](const auto& x, const auto& y) {
+        return x.first != y.first ? x.first > y.first : x.second < y.second;
+    });
+
+    // 4. Split while the budget lasts; a triangle is split at most once per pass
+    std::vector<unsigned char> touched(triangles.size(), 0);
+    for (const auto& candidate : m_remeshCandidates) {
+        if ((int)m_splits.size() >= maxRefinedParticles) break;
+        const EdgeFaces& faces = m_edgeFaces[candidate.second];
+        if (touched[faces.faces[0]] || touched[faces.faces[1]]) continue;
+        if (SplitEdge(m_edgeSprings[candidate.second], faces, deltaTime)) {
+            touched[faces.faces[0]] = touched[faces.faces[1]] = 1;
+        }
+    }
+}
+
+bool World::SplitEdge(unsigned int spring, const EdgeFaces& faces, float deltaTime) {
+    RemeshSplit split;
+    split.parentSpring = springs[spring];
+    split.spring = spring;
+    split.a = split.parentSpring.p1;
+    split.b = split.parentSpring.p2;
+    split.body = particleBody[split.a];
+    split.count = glm::min(faces.count, 2);
+    float restLength = split.parentSpring.restLength;
+
+    // 1. Rest length from the midpoint to each opposite corner: the median of the rest triangle
+    unsigned int opposite[2];
+    float median[2];
+    for (int k = 0; k < split.count; k++) {
+        const PoolTriangle& t = triangles[faces.faces[k]];
+        opposite[k] = t.p1 != split.a && t.p1 != split.b ? t.p1 : t.p2 != split.a && t.p2 != split.b ? t.p2 : t.p3;
+        auto ac = m_edgeSprings.find(EdgeKey(split.a, opposite[k]));
+        auto bc = m_edgeSprings.find(EdgeKey(split.b, opposite[k]));
+        if (ac == m_edgeSprings.end() || bc == m_edgeSprings.end()) return false;
+        float la = springs[ac->second].restLength, lb = springs[bc->second].restLength;
+        median[k] = 0.5f * sqrt(glm::max(0.0f, 2.0f * la * la + 2.0f * lb * lb - restLength * restLength));
+    }
+
+    // 2. Midpoint particle. Each endpoint hands over the share of its mass that sat on the
+    // halves now touching m (half the split triangles' area, relative to all of its triangles).
+    float area = 0.0f;
+    for (int k = 0; k < split.count; k++) area += RestArea(triangles[faces.faces[k]]);
+    const Particle& pa = particles[split.a];
+    const Particle& pb = particles[split.b];
+    split.massA = pa.isFixed || m_restAreas[split.a] <= 0.0f ? 0.0f : pa.mass * 0.5f * area / m_restAreas[split.a];
+    split.massB = pb.isFixed || m_restAreas[split.b] <= 0.0f ? 0.0f : pb.mass * 0.5f * area / m_restAreas[split.b];
+
+    // Lighter particles on the same springs need smaller steps: refuse the split if any
+    // particle it touches would leave the explicit step's stable range
+    const PoolSpring& parent = split.parentSpring;
+    glm::vec2 k(parent.springConstant, parent.dampingFactor);
+    auto Stable = [deltaTime](bool fixed, float mass, const glm::vec2& stiffness) {
+        return fixed || (mass > 0.0f && (deltaTime * deltaTime * stiffness.x + deltaTime * stiffness.y) / mass <= 1.0f);
+    };
+    if (!Stable(pa.isFixed && pb.isFixed, split.massA + split.massB, k * (float)(2 + split.count)) ||
+        !Stable(pa.isFixed, pa.mass - split.massA, m_stiffness[split.a]) ||
+        !Stable(pb.isFixed, pb.mass - split.massB, m_stiffness[split.b])) return false;
+    for (int c = 0; c < split.count; c++) {
+        const Particle& p = particles[opposite[c]];
+        if (!Stable(p.isFixed, p.mass, m_stiffness[opposite[c]] + k)) return false;
+    }
+    Particle mid((pa.position + pb.position) * 0.5f, split.massA + split.massB);
+    mid.velocity = (pa.velocity + pb.velocity) * 0.5f;
+    mid.normal = pa.normal;
+    mid.isFixed = pa.isFixed && pb.isFixed;
+    particles[split.a].mass -= split.massA;
+    particles[split.b].mass -= split.massB;
+    split.m = AllocateParticle(mid, split.body);
+    m_midpoints.resize(particles.size(), 0);
+    m_midpoints[split.m] = 1;
+    m_restAreas.resize(particles.size(), 0.0f);
+    m_restAreas[split.a] -= 0.5f * area;
+    m_restAreas[split.b] -= 0.5f * area;
+    m_restAreas[split.m] = area;
+    m_stiffness.resize(particles.size(), glm::vec2(0.0f));
+    m_stiffness[split.m] = k * (float)(2 + split.count);
+    for (int c = 0; c < split.count; c++) m_stiffness[opposite[c]] += k;
+
+    // 3. The edge's spring slot keeps a-m, the other springs take its constants
+    springs[spring].p2 = split.m;
+    springs[spring].restLength = restLength * 0.5f;
+    split.newSprings[0] = AllocateSpring({ split.m, split.b, parent.springConstant, parent.dampingFactor, restLength * 0.5f, true });
+    for (int k = 0; k < split.count; k++) {
+        split.newSprings[1 + k] = AllocateSpring({ split.m, opposite[k], parent.springConstant, parent.dampingFactor, median[k], true });
+    }
+
+    // 4. Each triangle becomes two with the same winding (a-side half in the old slot)
+    for (int k = 0; k < split.count; k++) {
+        PoolTriangle t = triangles[faces.faces[k]];
+        PoolTriangle first = t, second = t;
+        for (unsigned int* corner : { &first.p1, &first.p2, &first.p3 }) if (*corner == split.b) *corner = split.m;
+        for (unsigned int* corner : { &second.p1, &second.p2, &second.p3 }) if (*corner == split.a) *corner = split.m;
+        split.parents[k] = t;
+        split.slots[k] = faces.faces[k];
+        split.halves[k][0] = first;
+        split.halves[k][1] = second;
+        SetTriangle(faces.faces[k], first);
+        split.children[k] = AllocateTriangle(second);
+    }
+
+    m_edgeSprings.erase(EdgeKey(split.a, split.b));
+    bodies[split.body].splitCount++;
+    m_splits.push_back(split);
+    m_adjacencyDirty = true;
+    return true;
+}
+
+void World::UndoSplit(const RemeshSplit& split) {
+    for (int k = 0; k < split.count; k++) {
+        SetTriangle(split.slots[k], split.parents[k]);
+        ReleaseTriangle(split.children[k]);
+    }
+    springs[split.spring] = split.parentSpring;
+    for (int k = 0; k < 1 + split.count; k++) ReleaseSpring(split.newSprings[k]);
+    particles[split.a].mass += split.massA;
+    particles[split.b].mass += split.massB;
+    ReleaseParticle(split.m);
+    m_midpoints[split.m] = 0;
+    bodies[split.body].splitCount--;
+    m_adjacencyDirty = true;
+}
+
+float World::RestArea(const PoolTriangle& t) const {
+    // Heron's formula on the rest lengths of the edge springs, else the current area
+    auto rest = [this](unsigned int a, unsigned int b) {
+        auto s = m_edgeSprings.find(EdgeKey(a, b));
+        return s != m_edgeSprings.end() ? springs[s->second].restLength : -1.0f;
+    };
+    float a = rest(t.p1, t.p2), b = rest(t.p2, t.p3), c = rest(t.p3, t.p1);
+    if (a < 0.0f || b < 0.0f || c < 0.0f) {
+        return 0.5f * glm::length(glm::cross(particles[t.p2].position - particles[t.p1].position,
+                                             particles[t.p3].position - particles[t.p1].position));
+    }
+    float a2 = a * a, b2 = b * b, c2 = c * c;
+    return 0.25f * sqrt(glm::max(0.0f, 2.0f * (a2 * b2 + b2 * c2 + c2 * a2) - (a2 * a2 + b2 * b2 + c2 * c2)));
+}
+
+bool World::SplitIntact(const RemeshSplit& split) const {
+    // A later split inside one of the halves rewrote it (and owns m's neighbourhood now)
+    for (int k = 0; k < split.count; k++) {
+        for (int h = 0; h < 2; h++) {
+            const PoolTriangle& expected = split.halves[k][h];
+            const PoolTriangle& t = triangles[h == 0 ? split.slots[k] : split.children[k]];
+            if (!t.active || t.p1 != expected.p1 || t.p2 != expected.p2 || t.p3 != expected.p3) return false;
+        }
+    }
+    return true;
+}
+
+float World::SplitFold(const RemeshSplit& split) const {
+    // Largest angle between any two of the halves plus the strain of the two edge halves
+    glm::vec3 normals[4];
+    int count = 0;
+    for (int k = 0; k < split.count; k++) {
+        normals[count++] = FaceNormal(split.halves[k][0], particles);
+        normals[count++] = FaceNormal(split.halves[k][1], particles);
+    }
+    float angle = 0.0f;
+    for (int i = 0; i < count; i++) {
+        for (int j = i + 1; j < count; j++) angle = glm::max(angle, FaceAngle(normals[i], normals[j]));
+    }
+    float strain = 0.0f;
+    for (unsigned int i : { split.spring, split.newSprings[0] }) {
+        const PoolSpring& s = springs[i];
+        strain = glm::max(strain, std::abs(glm::distance(particles[s.p1].position, particles[s.p2].position) / s.restLength - 1.0f));
+    }
+    return angle + refineStrainWeight * strain;
+}
+
+unsigned int World::AllocateParticle(const Particle& p, unsigned int body) {
+    if (!m_freeParticles.empty()) {
+        unsigned int i = m_freeParticles.back();
+        m_freeParticles.pop_back();
+        particles[i] = p;
+        particleBody[i] = body;
+        if (i < previousPositions.size()) previousPositions[i] = p.position; // Don't blend from the old occupant
+        return i;
+    }
+    // Appending only grows the VBO (geometrically, see Draw), the index buffers are untouched
+    m_adjacencyDirty = true;
+    particles.push_back(p);
+    particleBody.push_back(body);
+    return (unsigned int)particles.size() - 1;
+}
+
+unsigned int World::AllocateSpring(const PoolSpring& s) {
+    m_adjacencyDirty = true;
+    if (!m_freeSprings.empty()) {
+        unsigned int i = m_freeSprings.back();
+        m_freeSprings.pop_back();
+        springs[i] = s;
+        springs[i].active = true;
+        return i;
+    }
+    springs.push_back(s);
+    springs.back().active = true;
+    return (unsigned int)springs.size() - 1;
+}
+
+unsigned int World::AllocateTriangle(const PoolTriangle& t) {
+    if (!m_freeTriangles.empty()) {
+        unsigned int i = m_freeTriangles.back();
+        m_freeTriangles.pop_back();
+        SetTriangle(i, t);
+        triangles[i].active = true;
+        return i;
+    }
+    // No free slot: the EBO has to be rebuilt once
+    triangles.push_back(t);
+    triangles.back().active = true;
+    m_meshDirty = true;
+    return (unsigned int)triangles.size() - 1;
+}
+
+void World::ReleaseParticle(unsigned int i) {
+    particles[i].mass = 0.0f;
+    particles[i].isFixed = true;
+    particleBody[i] = kFreeSlot;
+    m_freeParticles.push_back(i);
+}
+
+void World::ReleaseSpring(unsigned int i) {
+    springs[i].active = false;
+    m_freeSprings.push_back(i);
+    m_adjacencyDirty = true;
+}
+
+void World::ReleaseTriangle(unsigned int i) {
+    // A triangle with three equal indices rasterizes nothing
+    SetTriangle(i, { 0, 0, 0, triangles[i].body, false });
+    m_freeTriangles.push_back(i);
+}
+
+void World::SetTriangle(unsigned int i, const PoolTriangle& t) {
+    triangles[i] = t;
+    m_dirtyTriangles.push_back(i);
+    m_adjacencyDirty = true;
+}
+
+void World::TearSprings() {
+    // 1. Find overstretched springs in tearable bodies
+    m_tornSprings.clear();
+    for (unsigned int i = 0; i < springs.size(); i++) {
+        const PoolSpring& s = springs[i];
+        // Only springs inside one body tear (rope links to the canopy never do)
+        if (!s.active || particleBody[s.p1] != particleBody[s.p2]) continue;
+        const WorldBody& b = bodies[particleBody[s.p1]];
+        if (b.tearStretch <= 0.0f || !b.simulated || b.splitCount > 0) continue;
+        float tearStretch = b.tearStretch;
+        glm::vec3 e = particles[s.p2].position - particles[s.p1].position;
+        if (glm::dot(e, e) > tearStretch * tearStretch * s.restLength * s.restLength) {
+            m_tornSprings.push_back(i);
+        }
+    }
+    if (m_tornSprings.empty()) return;
+
+    // 2. Break the most stretched first and leave the rest for the next steps
+    std::sort(m_tornSprings.begin(), m_tornSprings.end(), [this](unsigned int a, unsigned int b) {
+        float la = glm::distance(particles[springs[a].p1].position, particles[springs[a].p2].position) / springs[a].restLength;
+        float lb = glm::distance(particles[springs[b].p1].position, particles[springs[b].p2].position) / springs[b].restLength;
+        return la > lb;
+    });
+    if ((int)m_tornSprings.size() > maxTearsPerStep) m_tornSprings.resize(maxTearsPerStep);
+
+    for (unsigned int i : m_tornSprings) {
+        if (!springs[i].active) continue;
+        unsigned int a = springs[i].p1;
+        unsigned int b = springs[i].p2;
+        ReleaseSpring(i);
+        int lod = bodies[particleBody[a]].lod;
+        if (lod >= 0) m_lods[lod].torn = true;
+
+        // Split the free endpoint; a spring between two pinned particles just breaks
+        if (!particles[a].isFixed) {
+            SplitParticle(a, b);
+        } else if (!particles[b].isFixed) {
+            SplitParticle(b, a);
+        }
+    }
+}
+
+void World::SplitParticle(unsigned int a, unsigned int b) {
+    // The crack runs through a, perpendicular to the broken spring a-b.
+    // Elements on b's side of that plane move to a new copy of a.
+    glm::vec3 origin = particles[a].position;
+    glm::vec3 dir = particles[b].position - origin;
+    float len = glm::length(dir);
+    if (len == 0.0f) return;
+    dir /= len;
+
+    const WorldBody& body = bodies[particleBody[a]];
+    auto OnFarSide = [&](const glm::vec3& p) {
+        return glm::dot(p - origin, dir) > 0.0f;
+    };
+
+    // 1. Only split when both sides keep at least one triangle
+    int nearCount = 0, farCount = 0;
+    for (unsigned int t = body.firstTriangle; t < body.firstTriangle + body.triangleCount; t++) {
+        const PoolTriangle& tri = triangles[t];
+        if (!tri.active || (tri.p1 != a && tri.p2 != a && tri.p3 != a)) continue;
+        glm::vec3 c = particles[tri.p1].position + particles[tri.p2].position + particles[tri.p3].position - origin;
+        if (OnFarSide(c * 0.5f)) farCount++; else nearCount++;
+    }
+    if (nearCount == 0 || farCount == 0) return;
+
+    // 2. Duplicate the particle, halving the mass between the two halves
+    Particle copy = particles[a];
+    copy.mass *= 0.5f;
+    particles[a].mass *= 0.5f;
+    unsigned int a2 = AllocateParticle(copy, particleBody[a]);
+
+    // 3. Re-point far side triangles (their EBO entries are patched in Draw)
+    for (unsigned int t = body.firstTriangle; t < body.firstTriangle + body.triangleCount; t++) {
+        PoolTriangle tri = triangles[t];
+        if (!tri.active || (tri.p1 != a && tri.p2 != a && tri.p3 != a)) continue;
+        glm::vec3 c = particles[tri.p1].position + particles[tri.p2].position + particles[tri.p3].position - origin;
+        if (!OnFarSide(c * 0.5f)) continue;
+        if (tri.p1 == a) tri.p1 = a2;
+        if (tri.p2 == a) tri.p2 = a2;
+        if (tri.p3 == a) tri.p3 = a2;
+        SetTriangle(t, tri);
+    }
+
+    // 4. Re-point far side springs
+    for (unsigned int i = body.firstSpring; i < body.firstSpring + body.springCount; i++) {
+        PoolSpring& s = springs[i];
+        if (!s.active) continue;
+        if (s.p1 == a && OnFarSide(particles[s.p2].position)) s.p1 = a2;
+        else if (s.p2 == a && OnFarSide(particles[s.p1].position)) s.p2 = a2;
+    }
+    m_adjacencyDirty = true;
+}
+
+void World::SetupMesh() {
+    if (!VAO) {
+        glGenVertexArrays(1, &VAO);
+        glGenVertexArrays(1, &lineVAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+        glGenBuffers(1, &lineEBO);
+        glGenBuffers(1, &previousVBO);
+    }
+
+    // Triangles are already grouped by body, so each body draws a contiguous index range
+    indices.clear();
+    for (const PoolTriangle& t : triangles) {
+        indices.push_back(t.p1);
+        indices.push_back(t.p2);
+        indices.push_back(t.p3);
+    }
+    lineIndices.clear();
+    for (const WorldBody& b : bodies) {
+        if (b.type != BodyType::Rope) continue;
+        for (unsigned int i = b.firstSpring; i < b.firstSpring + b.springCount; i++) {
+            lineIndices.push_back(springs[i].p1);
+            lineIndices.push_back(springs[i].p2);
+        }
+    }
+    vertexData.resize(particles.size() * 6);
+    m_vboCapacity = vertexData.size();
+    m_dirtyTriangles.clear();
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, m_vboCapacity * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    SetVertexAttributes(quantizedVertices); // The VBO is sized for floats, so packed data fits too
+    glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+    glBufferData(GL_ARRAY_BUFFER, m_vboCapacity / 6 * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(2);
+
+    // Ropes share the same vertex buffers, only the index buffer differs
+    glBindVertexArray(lineVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lineEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, lineIndices.size() * sizeof(unsigned int), lineIndices.data(), GL_STATIC_DRAW);
+    SetVertexAttributes(quantizedVertices);
+    glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+    m_meshDirty = false;
+    m_vaoPacked = quantizedVertices;
+}
+
+void World::UpdateMesh() {
+    // 1. Grow the VBO geometrically when tearing appended particles
+    size_t floatCount = particles.size() * 6;
+    if (floatCount > m_vboCapacity) {
+        m_vboCapacity = floatCount * 2;
+        glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_vboCapacity / 6 * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, m_vboCapacity * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    // 2. Patch only the EBO entries of triangles whose topology changed
+    if (!m_dirtyTriangles.empty()) {
+        std::sort(m_dirtyTriangles.begin(), m_dirtyTriangles.end());
+        m_dirtyTriangles.erase(std::unique(m_dirtyTriangles.begin(), m_dirtyTriangles.end()), m_dirtyTriangles.end());
+
+        glBindVertexArray(VAO);
+        size_t run = 0;
+        while (run < m_dirtyTriangles.size()) {
+            // Merge consecutive slots into one upload
+            size_t end = run + 1;
+            while (end < m_dirtyTriangles.size() && m_dirtyTriangles[end] == m_dirtyTriangles[end - 1] + 1) end++;
+            for (size_t k = run; k < end; k++) {
+                const PoolTriangle& t = triangles[m_dirtyTriangles[k]];
+                indices[m_dirtyTriangles[k] * 3 + 0] = t.p1;
+                indices[m_dirtyTriangles[k] * 3 + 1] = t.p2;
+                indices[m_dirtyTriangles[k] * 3 + 2] = t.p3;
+            }
+            GLintptr offset = m_dirtyTriangles[run] * 3 * sizeof(unsigned int);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, (end - run) * 3 * sizeof(unsigned int), &indices[m_dirtyTriangles[run] * 3]);
+            run = end;
+        }
+        glBindVertexArray(0);
+        m_dirtyTriangles.clear();
+    }
+
+    // 3. Stream positions and normals (packed: a third of the bytes)
+    if (quantizedVertices) {
+        packedData.resize(particles.size());
+        packedBounds = ComputePackedBounds(particles.data(), particles.size());
+        PackVertices(particles.data(), particles.size(), packedBounds, packedData.data());
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, packedData.size() * sizeof(PackedVertex), packedData.data());
+    } else {
+        vertexData.resize(floatCount);
+        int index = 0;
+        for (const Particle& p : particles) {
+            vertexData[index++] = p.position.x;
+            vertexData[index++] = p.position.y;
+            vertexData[index++] = p.position.z;
+            vertexData[index++] = p.normal.x;
+            vertexData[index++] = p.normal.y;
+            vertexData[index++] = p.normal.z;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertexData.size() * sizeof(float), vertexData.data());
+    }
+
+    // 4. Previous tick positions; particles split off since then start at their current position
+    if (interpolate) {
+        for (size_t i = previousPositions.size(); i < particles.size(); i++) {
+            previousPositions.push_back(particles[i].position);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, previousVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, particles.size() * sizeof(glm::vec3), previousPositions.data());
+    }
+}
+
+void World::StorePreviousPositions() {
+    previousPositions.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); i++) {
+        previousPositions[i] = particles[i].position;
+    }
+}
+
+void World::Draw(unsigned int shaderProgram) {
+    glUseProgram(shaderProgram);
+    if (m_meshDirty || quantizedVertices != m_vaoPacked) SetupMesh();
+    UpdateMesh();
+    if (quantizedVertices) SetPackedBoundsUniforms(shaderProgram, packedBounds);
+
+    int colorLocation = glGetUniformLocation(shaderProgram, "objectColor");
+
+    // One upload for the whole pool, one draw call per body for its color.
+    // Triangles appended at runtime (remeshing) sit in the gaps between the body ranges
+    // (bodies are built in pool order) and are drawn in runs of one owner.
+    glBindVertexArray(VAO);
+    auto DrawRuns = [&](unsigned int begin, unsigned int end) {
+        while (begin < end) {
+            unsigned int run = begin + 1;
+            while (run < end && triangles[run].body == triangles[begin].body) run++;
+            const WorldBody& b = bodies[triangles[begin].body];
+            if (!b.lodTwin) {
+                glUniform3fv(colorLocation, 1, &b.color[0]);
+                glDrawElements(GL_TRIANGLES, (run - begin) * 3, GL_UNSIGNED_INT, (void*)(begin * 3 * sizeof(unsigned int)));
+            }
+            begin = run;
+        }
+    };
+    unsigned int cursor = 0;
+    for (const WorldBody& b : bodies) {
+        DrawRuns(cursor, b.firstTriangle);
+        cursor = glm::max(cursor, b.firstTriangle + b.triangleCount);
+        if (b.triangleCount == 0 || b.lodTwin) continue;
+        glUniform3fv(colorLocation, 1, &b.color[0]);
+        glDrawElements(GL_TRIANGLES, b.triangleCount * 3, GL_UNSIGNED_INT, (void*)(b.firstTriangle * 3 * sizeof(unsigned int)));
+    }
+    DrawRuns(cursor, (unsigned int)triangles.size());
+
+    // Rope bodies were appended to lineIndices in body order
+    glBindVertexArray(lineVAO);
+    unsigned int lineOffset = 0;
+    for (const WorldBody& b : bodies) {
+        if (b.type != BodyType::Rope) continue;
+        glUniform3fv(colorLocation, 1, &b.color[0]);
+        glDrawElements(GL_LINES, b.springCount * 2, GL_UNSIGNED_INT, (void*)(lineOffset * sizeof(unsigned int)));
+        lineOffset += b.springCount * 2;
+    }
+    glBindVertexArray(0);
+}
@@ -0,0 +1,182 @@
+#include "WrinkleRenderer.h"
+#include "Cloth.h"
+#include <glm/gtc/constants.hpp> // For glm::pi
+#include <algorithm>
+#include <cmath>
+
+WrinkleRenderer::WrinkleRenderer() {
+    subdivisions = 2;
+    wrinkleAmplitude = 1.0f;
+    wrinkleWavelength = 4.0f;
+    VAO = VBO = EBO = 0;
+    m_width = m_height = 0;
+    m_meshDirty = true;
+}
+
+WrinkleRenderer::~WrinkleRenderer() {
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
+}
+
+// Catmull-Rom weights of the points at -1, 0, 1 and 2 for a parameter t in [0, 1]
+static void CatmullRomWeights(float t, float w[4]) {
+    float t2 = t * t, t3 = t2 * t;
+    w[0] = 0.5f * (-t3 + 2.0f * t2 - t);
+    w[1] = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+    w[2] = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+    w[3] = 0.5f * (t3 - t2);
+}
+
+void WrinkleRenderer::Update(const Cloth& cloth) {
+    int s = std::max(subdivisions, 1);
+    int clothWidth = cloth.m_width, clothHeight = cloth.m_height;
+    if (clothWidth < 2 || clothHeight < 2) return;
+    int width = (clothWidth - 1) * s + 1, height = (clothHeight - 1) * s + 1;
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        BuildIndices();
+    }
+    // Clamped at the borders, which makes the patch's end tangents one-sided
+    auto particle = [&](int x, int y) -> const glm::vec3& {
+        x = std::min(std::max(x, 0), clothWidth - 1);
+        y = std::min(std::max(y, 0), clothHeight - 1);
+        return cloth.particles[y * clothWidth + x]->position;
+    };
+
+    // 1. Compression of the structural springs at every particle, per grid axis
+    float rest = cloth.structural.restLength;
+    m_compression.resize((size_t)clothWidth * clothHeight);
+    for (int y = 0; y < clothHeight; y++) {
+        for (int x = 0; x < clothWidth; x++) {
+            glm::vec2 sum(0.0f), count(0.0f);
+            for (int d = -1; d <= 1; d += 2) {
+                if (x + d >= 0 && x + d < clothWidth) {
+                    sum.x += std::max(0.0f, 1.0f - glm::distance(particle(x, y), particle(x + d, y)) / rest);
+                    count.x++;
+                }
+                if (y + d >= 0 && y + d < clothHeight) {
+                    sum.y += std::max(0.0f, 1.0f - glm::distance(particle(x, y), particle(x, y + d)) / rest);
+                    count.y++;
+                }
+            }
+            m_compression[y * clothWidth + x] = sum / glm::max(count, glm::vec2(1.0f));
+        }
+    }
+
+    // 2. Render vertices on the Catmull-Rom patch through the particles
+    m_positions.resize((size_t)width * height);
+    for (int gy = 0; gy < height; gy++) {
+        int cy = std::min(gy / s, clothHeight - 2);
+        float wy[4];
+        CatmullRomWeights((float)(gy - cy * s) / s, wy);
+        for (int gx = 0; gx < width; gx++) {
+            int cx = std::min(gx / s, clothWidth - 2);
+            float wx[4];
+            CatmullRomWeights((float)(gx - cx * s) / s, wx);
+            glm::vec3 p(0.0f);
+            for (int j = 0; j < 4; j++) {
+                for (int i = 0; i < 4; i++) p += (wy[j] * wx[i]) * particle(cx - 1 + i, cy - 1 + j);
+            }
+            m_positions[gy * width + gx] = p;
+        }
+    }
+    ComputeNormals();
+
+    // 3. Wrinkles: compression along x folds into ridges across x and vice versa
+    float wavelength = std::max(wrinkleWavelength, 2.0f);
+    float amplitude = wrinkleAmplitude * wavelength * (cloth.m_spacing / s) / glm::pi<float>();
+    if (amplitude > 0.0f) {
+        float k = 2.0f * glm::pi<float>() / wavelength;
+        for (int gy = 0; gy < height; gy++) {
+            int cy = std::min(gy / s, clothHeight - 2);
+            float ty = (float)(gy - cy * s) / s;
+            for (int gx = 0; gx < width; gx++) {
+                int cx = std::min(gx / s, clothWidth - 2);
+                float tx = (float)(gx - cx * s) / s;
+                const glm::vec2* c = &m_compression[cy * clothWidth + cx];
+                glm::vec2 compression = glm::mix(glm::mix(c[0], c[1], tx),
+                                                 glm::mix(c[clothWidth], c[clothWidth + 1], tx), ty);
+                float d = amplitude * (std::sqrt(compression.x) * std::cos(k * gx) +
+                                       std::sqrt(compression.y) * std::cos(k * gy));
+                m_positions[gy * width + gx] += m_normals[gy * width + gx] * d;
+            }
+        }
+        ComputeNormals();
+    }
+
+    // 4. Interleave for the VBO
+    vertexData.resize(m_positions.size() * 6);
+    int index = 0;
+    for (size_t i = 0; i < m_positions.size(); i++) {
+        vertexData[index++] = m_positions[i].x;
+        vertexData[index++] = m_positions[i].y;
+        vertexData[index++] = m_positions[i].z;
+        vertexData[index++] = m_normals[i].x;
+        vertexData[index++] = m_normals[i].y;
+        vertexData[index++] = m_normals[i].z;
+    }
+}
+
+void WrinkleRenderer::ComputeNormals() {
+    // Central differences on the render grid, oriented like the cloth's triangle normals
+    auto position = [this](int x, int y) {
+        x = std::min(std::max(x, 0), m_width - 1);
+        y = std::min(std::max(y, 0), m_height - 1);
+        return m_positions[y * m_width + x];
+    };
+    m_normals.resize(m_positions.size());
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            glm::vec3 n = glm::cross(position(x, y + 1) - position(x, y - 1), position(x + 1, y) - position(x - 1, y));
+            m_normals[y * m_width + x] = glm::length(n) > 0.0f ? glm::normalize(n) : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    }
+}
+
+void WrinkleRenderer::BuildIndices() {
+    indices.clear();
+    for (int y = 0; y < m_height - 1; ++y) {
+        for (int x = 0; x < m_width - 1; ++x) {
+            unsigned int tl = (unsigned int)(y * m_width + x), tr = tl + 1;
+            unsigned int bl = tl + m_width, br = bl + 1;
+            indices.insert(indices.end(), { tl, bl, tr, tr, bl, br });
+        }
+    }
+    m_meshDirty = true;
+}
+
+void WrinkleRenderer::SetupMesh() {
+    if (!VAO) {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+    }
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    m_meshDirty = false;
+}
+
+void WrinkleRenderer::Draw(unsigned int shaderProgram) {
+    if (indices.empty()) return;
+    glUseProgram(shaderProgram);
+    // A new subdivision level (or cloth size) resizes both buffers
+    if (m_meshDirty) SetupMesh();
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertexData.size() * sizeof(float), vertexData.data());
+    glBindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
@@ -6,7 +6,12 @@
 #include "Shader.h"
 #include "Camera.h"
 #include "Cloth.h"
+#include "GridCloth.h"
+#include "WrinkleRenderer.h"
 #include "ParachuteSystem.h" // Includes the new scene
+#include "World.h"
+#include "WindField.h"
+#include "ParallelFor.h"
 
 // ImGui Headers
 #include <imgui.h>
@@ -22,8 +27,9 @@ float lastFrame = 0.0f;
 
 bool dropCloth = false;
 bool dropParachute = false;
+bool dropWorld = false;
 bool rKeyWasPressed = false;
-int currentScene = 1; // 1 = Cloth, 2 = Parachute
+int currentScene = 1; // 1 = Cloth, 2 = Parachute, 3 = World
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
@@ -68,6 +74,8 @@ void processInput(GLFWwindow *window) {
             dropCloth = true;
         else if (currentScene == 2)
             dropParachute = true;
+        else if (currentScene == 3)
+            dropWorld = true;
     }
         
     // Scene switching keys
@@ -75,6 +83,8 @@ void processInput(GLFWwindow *window) {
         currentScene = 1;
     if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS)
         currentScene = 2;
+    if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS)
+        currentScene = 3;
 }
 
 int main () {
@@ -103,13 +113,36 @@ int main () {
 
     // 1. Initialize Shaders and Scenes
     Shader clothShader("Shader/cloth.vert", "Shader/cloth.frag");
+    // Same lighting, but normals rebuilt in the vertex shader from uploaded positions
+    Shader gpuNormalShader("Shader/cloth_gpunormal.vert", "Shader/cloth.frag");
+    // Blends the last two fixed physics ticks (interpolated rendering)
+    Shader interpShader("Shader/cloth_interp.vert", "Shader/cloth.frag");
+    // Decodes the packed 8-byte vertices (also blends ticks when interpolating)
+    Shader quantizedShader("Shader/cloth_quantized.vert", "Shader/cloth.frag");
     
     // Scene 1: Width (nodes), Height (nodes), Spacing, Total Mass
     Cloth myCloth(20, 20, 0.4f, 2.0f);
+    // Same sheet on the stencil fast path (no spring or triangle objects)
+    GridCloth myGridCloth(20, 20, 0.4f, 2.0f);
+    // Same sheet simulated coarse and drawn finer with procedural wrinkles
+    int coarseResolution = 10;
+    Cloth myCoarseCloth(coarseResolution, coarseResolution, 7.6f / (coarseResolution - 1), 2.0f);
+    WrinkleRenderer wrinkleRenderer;
 
     // Scene 2: Parachute System
     ParachuteSystem myParachute(glm::vec3(0.0f, 40.0f, 0.0f));
 
+    // Scene 3: Rows of flags and several parachutes sharing one particle pool
+    World myWorld;
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 6; col++) {
+            myWorld.AddCloth(glm::vec3(-15.0f + col * 6.0f, 4.0f, -5.0f - row * 6.0f), 10, 10, 0.4f, 1.0f);
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        myWorld.AddParachute(glm::vec3(-20.0f + i * 20.0f, 40.0f, -30.0f));
+    }
+
     glm::vec3 wind(0.0f, 0.0f, 0.0f); // A gentle breeze blowing back
 
     // --- Ground Plane Setup ---
@@ -145,12 +178,50 @@ int main () {
     float swirlSpeed = 0.f;
     float turbulenceStrength = 0.0f;
 
+    // --- Spatially varying wind: curl-noise grid covering all three scenes ---
+    WindField windField(glm::vec3(-30.0f, -12.0f, -40.0f), glm::vec3(30.0f, 45.0f, 10.0f), 2.0f);
+    bool useWindField = false;
+    float windFieldStrength = 2.0f;
+
     // --- Cloth Pin Selection (Grid Coordinates 0 to 19) ---
     int pinLeftX = 0;
     int pinLeftY = 0;
     int pinRightX = 19;
     int pinRightY = 0;
 
+    // --- Scene 3 tearing (springs break beyond this multiple of rest length) ---
+    bool tearing = false;
+    float tearStretch = 1.5f;
+
+    // --- Scenes 1 and 2: derive cloth normals on the GPU instead of every substep ---
+    bool useGpuNormals = false;
+
+    // --- Cloth meshes upload 16-bit positions and 8-bit octahedral normals ---
+    bool useQuantizedVertices = false;
+
+    // --- Scene 1: run the sheet on GridCloth (no interpolation or GPU normals there) ---
+    bool useGridCloth = false;
+
+    // --- Scene 1: simulate myCoarseCloth and draw it through wrinkleRenderer ---
+    bool useWrinkles = false;
+
+    // --- Fixed-rate physics with interpolated rendering ---
+    // Physics advances in ticks of 1 / physicsRate; rendering blends the last two ticks
+    // by the leftover time, so a low physics rate still displays smoothly.
+    bool interpolateRendering = false;
+    int physicsRate = 120;               // Ticks per second
+    float maxSubStep = 1.0f / 960.0f;    // Same range of substep sizes as the per-frame path
+    float physicsAccumulator = 0.0f;
+    float renderAlpha = 1.0f;
+
+    // --- Worker threads for the parallel passes (0 = one per hardware thread) ---
+    int threadCount = 0;
+
+    // --- Total energy of the last physics step, one sample per frame (scenes 1-2) ---
+    const int energyHistorySize = 240;
+    float energyHistory[energyHistorySize] = {};
+    int energyHistoryOffset = 0;
+
     //----------------------------------------------------------
     // 2. Main Render Loop
     while (!glfwWindowShouldClose(window)) {
@@ -165,11 +236,20 @@ int main () {
         if (rKeyDown && !rKeyWasPressed) {
             if (currentScene == 1) {
                 myCloth.Reset();
+                myGridCloth.Reset();
+                myCoarseCloth.Reset();
                 dropCloth = false;
             } else if (currentScene == 2) {
                 myParachute.Reset();
                 dropParachute = false;
+            } else if (currentScene == 3) {
+                myWorld.Reset();
+                dropWorld = false;
             }
+            // Don't blend from the pre-reset state
+            myCloth.StorePreviousPositions();
+            myParachute.StorePreviousPositions();
+            myWorld.StorePreviousPositions();
         }
         rKeyWasPressed = rKeyDown;
 
@@ -186,7 +266,7 @@ int main () {
         ImGui::Begin("Simulation Controls");
         
         ImGui::Text("Current Scene: %d", currentScene);
-        ImGui::Text("Press '1' for Cloth, '2' for Parachute");
+        ImGui::Text("Press '1' for Cloth, '2' for Parachute, '3' for World");
         ImGui::Separator();
 
         ImGui::Text("Wind Options");
@@ -194,6 +274,41 @@ int main () {
         ImGui::SliderFloat("Speed Variance", &windSpeedVariance, 0.0f, 10.0f);
         ImGui::SliderFloat("Swirl Speed", &swirlSpeed, 0.0f, 5.0f);
         ImGui::SliderFloat("Turbulence", &turbulenceStrength, 0.0f, 5.0f);
+        ImGui::Checkbox("Wind Field (curl noise)", &useWindField);
+        ImGui::SliderFloat("Field Strength", &windFieldStrength, 0.0f, 10.0f);
+
+        ImGui::Separator();
+        ImGui::Checkbox("GPU Normals (scenes 1-2)", &useGpuNormals);
+        ImGui::Checkbox("Quantized Vertices (scenes 1-3)", &useQuantizedVertices);
+        ImGui::Checkbox("Grid Fast Path (scene 1)", &useGridCloth);
+        ImGui::Checkbox("Coarse Sim + Wrinkles (scene 1)", &useWrinkles);
+        if (useWrinkles) {
+            // Same 7.6 m sheet at any particle count
+            if (ImGui::SliderInt("Sim Resolution", &coarseResolution, 4, 20)) {
+                myCoarseCloth.m_width = myCoarseCloth.m_height = coarseResolution;
+                myCoarseCloth.m_spacing = 7.6f / (coarseResolution - 1);
+                myCoarseCloth.Reset();
+            }
+            ImGui::SliderInt("Render Subdivisions", &wrinkleRenderer.subdivisions, 1, 4);
+            ImGui::SliderFloat("Wrinkle Amplitude", &wrinkleRenderer.wrinkleAmplitude, 0.0f, 2.0f);
+        }
+        // The PD factor is built for one step size, and the per-frame loop changes it every
+        // frame: projective dynamics runs with the fixed-rate loop only
+        if (ImGui::Checkbox("Projective Dynamics (scene 1, fixed-rate)", &myCloth.projectiveDynamics)) {
+            if (myCloth.projectiveDynamics) interpolateRendering = true;
+        }
+        if (myCloth.projectiveDynamics) {
+            ImGui::Checkbox("PD Multigrid Solve", &myCloth.pdSolver.multigrid);
+            ImGui::Text("PD factorizations: %zu", myCloth.pdSolver.FactorCount());
+        }
+        ImGui::Checkbox("Jacobi Self-Collision (scene 2)", &myParachute.jacobiSelfCollision);
+        ImGui::Checkbox("Exact Ropes (scene 2)", &myParachute.exactRopes);
+        ImGui::Checkbox("Deterministic Threads", &GetParallelSettings().deterministic);
+        ImGui::SliderInt("Threads (0 = all)", &threadCount, 0, 64);
+        if (ImGui::Checkbox("Fixed-Rate Physics (interpolated)", &interpolateRendering)) {
+            if (!interpolateRendering) myCloth.projectiveDynamics = false;
+        }
+        ImGui::SliderInt("Physics Rate (Hz)", &physicsRate, 30, 240);
         
         ImGui::Separator();
         ImGui::Text("Scene 1 Pinned Particles (Grid X, Y)");
@@ -204,6 +319,23 @@ int main () {
         if (ImGui::Button(dropCloth ? "Reset Cloth (Pin Again)" : "Drop Cloth (Spacebar)")) {
             dropCloth = !dropCloth;
         }
+
+        ImGui::Separator();
+        bool tearingChanged = ImGui::Checkbox("Tearing (scene 3)", &tearing);
+        if (tearing) tearingChanged |= ImGui::SliderFloat("Tear Stretch", &tearStretch, 1.05f, 3.0f);
+        if (tearingChanged) myWorld.SetTearStretch(tearing ? tearStretch : 0.0f);
+        ImGui::Checkbox("Gather Forces (parallel)", &myWorld.gatherForces);
+        ImGui::Checkbox("Simulation LOD (scene 3)", &myWorld.simulationLod);
+        if (myWorld.simulationLod) {
+            ImGui::SliderFloat2("LOD Distances", myWorld.lodDistances, 5.0f, 100.0f);
+            ImGui::Text("Simulated particles: %zu", myWorld.SimulatedParticleCount());
+        }
+        ImGui::Checkbox("Adaptive Remesh (scene 3)", &myWorld.adaptiveRemesh);
+        if (myWorld.adaptiveRemesh) {
+            ImGui::SliderFloat("Refine Angle", &myWorld.refineAngle, 0.2f, 1.5f);
+            ImGui::SliderInt("Max Midpoints", &myWorld.maxRefinedParticles, 0, 2048);
+            ImGui::Text("Midpoints: %zu", myWorld.RefinedParticleCount());
+        }
         ImGui::End();
 
         // --- Apply Pin Selection (Only relevant for Scene 1) ---
@@ -212,12 +344,25 @@ int main () {
             for (Particle* p : myCloth.particles) {
                 p->isFixed = false;
             }
+            for (unsigned char& pin : myGridCloth.pinned) {
+                pin = 0;
+            }
+            for (Particle* p : myCoarseCloth.particles) {
+                p->isFixed = false;
+            }
             // 2. Pin the individually selected particles if not dropped
             if (!dropCloth) {
-                int idx1 = pinLeftY * 20 + pinLeftX;
-                int idx2 = pinRightY * 20 + pinRightX;
-                if (idx1 >= 0 && idx1 < myCloth.particles.size()) myCloth.particles[idx1]->isFixed = true;
-                if (idx2 >= 0 && idx2 < myCloth.particles.size()) myCloth.particles[idx2]->isFixed = true;
+                // The sliders keep the coordinates in 0..19, so the indices are never negative
+                size_t idx1 = (size_t)(pinLeftY * 20 + pinLeftX);
+                size_t idx2 = (size_t)(pinRightY * 20 + pinRightX);
+                if (idx1 < myCloth.particles.size()) myCloth.particles[idx1]->isFixed = true;
+                if (idx2 < myCloth.particles.size()) myCloth.particles[idx2]->isFixed = true;
+                if (idx1 < myGridCloth.pinned.size()) myGridCloth.pinned[idx1] = 1;
+                if (idx2 < myGridCloth.pinned.size()) myGridCloth.pinned[idx2] = 1;
+                // The coarse sheet pins the nearest particle to the same spot
+                int n = myCoarseCloth.m_width - 1;
+                myCoarseCloth.particles[(pinLeftY * n + 9) / 19 * (n + 1) + (pinLeftX * n + 9) / 19]->isFixed = true;
+                myCoarseCloth.particles[(pinRightY * n + 9) / 19 * (n + 1) + (pinRightX * n + 9) / 19]->isFixed = true;
             }
         }
         
@@ -245,38 +390,121 @@ int main () {
             sin(time * 3.3f)
         ) * turbulenceStrength;
 
+        // The grid is regenerated at its own (lower) rate; objects sample it per triangle
+        windField.turbulenceStrength = windFieldStrength;
+        windField.Update(deltaTime);
+        const WindField* activeField = useWindField ? &windField : nullptr;
+        myCloth.windField = activeField;
+        myGridCloth.windField = activeField;
+        myCoarseCloth.windField = activeField;
+        myParachute.windField = activeField;
+        GetParallelSettings().threadCount = (size_t)threadCount;
+        myWorld.windField = activeField;
+
+        myCloth.gpuNormals = useGpuNormals;
+        myParachute.canopy->gpuNormals = useGpuNormals;
+        myCloth.quantizedVertices = useQuantizedVertices;
+        myParachute.canopy->quantizedVertices = useQuantizedVertices;
+        myWorld.quantizedVertices = useQuantizedVertices;
+        myCloth.interpolate = interpolateRendering;
+        myParachute.interpolate = interpolateRendering;
+        myParachute.canopy->interpolate = interpolateRendering;
+        myParachute.crate->interpolate = interpolateRendering;
+        myWorld.interpolate = interpolateRendering;
+
         // --- Trigger parachute drop if space was pressed in scene 2 ---
         if (dropParachute && currentScene == 2) {
             myParachute.StartFalling();
         }
+        if (dropWorld && currentScene == 3) {
+            myWorld.ReleaseParachutes();
+        }
+        if (currentScene == 3) {
+            myWorld.UpdateLod(camera.Position);
+        }
 
         // --- Physics Integration ---
-        int subSteps = 30;
-        float subDeltaTime = deltaTime / subSteps;
-        for(int i = 0; i < subSteps; i++) {
-            if (currentScene == 1) {
-                myCloth.UpdatePhysics(subDeltaTime, wind);
+        auto stepScene = [&](float dt) {
+            if (currentScene == 1 && useGridCloth) {
+                myGridCloth.UpdatePhysics(dt, wind);
+            } else if (currentScene == 1 && useWrinkles) {
+                myCoarseCloth.UpdatePhysics(dt, wind);
+            } else if (currentScene == 1) {
+                myCloth.UpdatePhysics(dt, wind);
             } else if (currentScene == 2) {
-                myParachute.UpdatePhysics(subDeltaTime, wind);
+                myParachute.UpdatePhysics(dt, wind);
+            } else if (currentScene == 3) {
+                myWorld.UpdatePhysics(dt, wind);
+            }
+        };
+        if (interpolateRendering) {
+            float tick = 1.0f / physicsRate;
+            int subSteps = (int)ceil(tick / maxSubStep);
+            physicsAccumulator += deltaTime;
+            while (physicsAccumulator >= tick) {
+                if (currentScene == 1) {
+                    myCloth.StorePreviousPositions();
+                } else if (currentScene == 2) {
+                    myParachute.StorePreviousPositions();
+                } else if (currentScene == 3) {
+                    myWorld.StorePreviousPositions();
+                }
+                for (int i = 0; i < subSteps; i++) stepScene(tick / subSteps);
+                physicsAccumulator -= tick;
+            }
+            renderAlpha = physicsAccumulator / tick;
+        } else {
+            int subSteps = 30;
+            float subDeltaTime = deltaTime / subSteps;
+            for(int i = 0; i < subSteps; i++) {
+                stepScene(subDeltaTime);
             }
+            physicsAccumulator = 0.0f;
+            renderAlpha = 1.0f;
         }
 
+        // --- Diagnostics of the scene's last physics step ---
+        const SimDiagnostics* diagnostics = nullptr;
+        if (currentScene == 1 && !useGridCloth) diagnostics = useWrinkles ? &myCoarseCloth.diagnostics : &myCloth.diagnostics;
+        if (currentScene == 2 && myParachute.falling) diagnostics = &myParachute.diagnostics;
+        ImGui::Begin("Diagnostics");
+        if (diagnostics) {
+            energyHistory[energyHistoryOffset] = diagnostics->TotalEnergy();
+            energyHistoryOffset = (energyHistoryOffset + 1) % energyHistorySize;
+            ImGui::Text("Kinetic       %10.3f J", diagnostics->kineticEnergy);
+            ImGui::Text("Gravitational %10.3f J", diagnostics->gravitationalEnergy);
+            ImGui::Text("Elastic       %10.3f J", diagnostics->elasticEnergy);
+            ImGui::Text("Total         %10.3f J", diagnostics->TotalEnergy());
+            ImGui::Text("Momentum      (%.2f, %.2f, %.2f)", diagnostics->momentum.x, diagnostics->momentum.y, diagnostics->momentum.z);
+            ImGui::Text("Max strain    %10.4f", diagnostics->maxStrain);
+            ImGui::PlotLines("Total Energy", energyHistory, energyHistorySize, energyHistoryOffset, nullptr, FLT_MAX, FLT_MAX, ImVec2(0, 60));
+        } else {
+            ImGui::Text("Available for scene 1 (Cloth) and scene 2 once dropped");
+        }
+        ImGui::End();
+
         // Render Background (Grey to match screenshot)
         glClearColor(0.4f, 0.4f, 0.45f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Activate Shader & Set shared camera uniforms
-        clothShader.use();
-        clothShader.setVec3("lightDir", glm::vec3(-0.5f, -1.0f, -0.5f));
-        clothShader.setVec3("viewPos", camera.Position);
-
+        // Set shared camera uniforms on every shader that draws this frame
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 100.0f);
         glm::mat4 view = camera.GetViewMatrix();
         glm::mat4 model = glm::mat4(1.0f); // Identity matrix so everything renders at its actual coordinates
-    
-        clothShader.setMat4("projection", projection);
-        clothShader.setMat4("view", view);
-        clothShader.setMat4("model", model);
+
+        for (Shader* shader : { &gpuNormalShader, &interpShader, &quantizedShader, &clothShader }) {
+            shader->use();
+            shader->setVec3("lightDir", glm::vec3(-0.5f, -1.0f, -0.5f));
+            shader->setVec3("viewPos", camera.Position);
+            shader->setMat4("projection", projection);
+            shader->setMat4("view", view);
+            shader->setMat4("model", model);
+            shader->setFloat("alpha", renderAlpha);
+        }
+        // The ground is static; simulated meshes blend the last two ticks when interpolating
+        Shader& meshShader = interpolateRendering ? interpShader : clothShader;
+        Shader& clothMeshShader = useQuantizedVertices ? quantizedShader : meshShader;
+        Shader& canopyShader = useGpuNormals ? gpuNormalShader : clothMeshShader;
 
         // 1. DRAW GROUND
         clothShader.setVec3("objectColor", glm::vec3(0.85f, 0.85f, 0.82f)); 
@@ -285,22 +513,42 @@ int main () {
         glBindVertexArray(0);
 
         // 2. DRAW ACTIVE SCENE
-        if (currentScene == 1) {
-            clothShader.setVec3("objectColor", glm::vec3(0.55f, 0.15f, 0.15f)); 
-            myCloth.Draw(clothShader.ID);
+        if (currentScene == 1 && useGridCloth) {
+            // Draws the latest tick with CPU normals
+            clothShader.use();
+            clothShader.setVec3("objectColor", glm::vec3(0.55f, 0.15f, 0.15f));
+            myGridCloth.Draw(clothShader.ID);
+        }
+        else if (currentScene == 1 && useWrinkles) {
+            // Draws the latest tick on the subdivided mesh
+            clothShader.use();
+            clothShader.setVec3("objectColor", glm::vec3(0.55f, 0.15f, 0.15f));
+            wrinkleRenderer.Update(myCoarseCloth);
+            wrinkleRenderer.Draw(clothShader.ID);
+        }
+        else if (currentScene == 1) {
+            canopyShader.use();
+            canopyShader.setVec3("objectColor", glm::vec3(0.55f, 0.15f, 0.15f)); 
+            myCloth.Draw(canopyShader.ID);
         } 
         else if (currentScene == 2) {
             // Parachute Canopy (Green)
-            clothShader.setVec3("objectColor", glm::vec3(0.15f, 0.55f, 0.15f)); 
-            myParachute.canopy->Draw(clothShader.ID);
+            canopyShader.use();
+            canopyShader.setVec3("objectColor", glm::vec3(0.15f, 0.55f, 0.15f)); 
+            myParachute.canopy->Draw(canopyShader.ID);
 
             // Ropes (Dark Grey/Black lines)
-            clothShader.setVec3("objectColor", glm::vec3(0.1f, 0.1f, 0.1f)); 
-            myParachute.DrawLines(clothShader.ID);
+            meshShader.use();
+            meshShader.setVec3("objectColor", glm::vec3(0.1f, 0.1f, 0.1f)); 
+            myParachute.DrawLines(meshShader.ID);
 
             // Crate (Solid brown box)
-            clothShader.setVec3("objectColor", glm::vec3(0.55f, 0.35f, 0.15f)); 
-            myParachute.DrawCrate(clothShader.ID);
+            meshShader.setVec3("objectColor", glm::vec3(0.55f, 0.35f, 0.15f)); 
+            myParachute.DrawCrate(meshShader.ID);
+        }
+        else if (currentScene == 3) {
+            // Every body sets its own color
+            myWorld.Draw(clothMeshShader.ID);
         }
 
         // 3. RENDER IMGUI
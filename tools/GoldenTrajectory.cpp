@@ -0,0 +1,477 @@
+// GoldenTrajectory.cpp (Headless regression check for the physics kernels)
+//
+// Runs every solver path (the cloth, parachute and obstacle scenes, projective dynamics, Jacobi
+// self-collision, exact ropes, the grid fast path and the shared-pool world) for a fixed number
+// of fixed-size steps and compares the particle states at a few sample steps against reference
+// files. Registered with CTest as the "golden" test. Prints the largest
+// position and velocity deviation per body and fails if any exceeds the tolerance.
+// Record new references only when a change is meant to alter the results.
+// --threads instead checks the deterministic mode of ParallelReduce (the "threads" test): the
+// threaded scenes must give bit-identical states and diagnostics with 1, 4 and 32 threads,
+// and at least one must change between 1 and 4 threads once deterministic mode is off.
+//
+// Examples:
+//   GoldenTrajectory --check tools/golden
+//   GoldenTrajectory --record tools/golden
+//   GoldenTrajectory --threads
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Cloth.h"
+#include "GridCloth.h"
+#include "ParachuteSystem.h"
+#include "ParallelFor.h"
+#include "SimDiagnostics.h"
+#include "World.h"
+
+// One named group of particles whose positions and velocities are compared
+struct BodyState {
+    std::string name;
+    std::vector<glm::vec3> positions, velocities;
+};
+
+struct Sample {
+    int step;
+    std::vector<BodyState> bodies;
+    SimDiagnostics diagnostics; // Of the sampled step, where the scene has them (not stored in files)
+};
+
+struct Scenario {
+    const char* name;
+    float timeStep;
+    int steps;
+    int samples; // Evenly spaced, the last one at the final step
+    std::vector<Sample> (*run)(const Scenario&);
+};
+
+static const float kTimeStep = 1.0f / 1800.0f; // Same substep as the interactive loop
+static const glm::vec3 kWind(2.0f, 0.0f, 1.0f); // Nonzero so drag is covered
+static const int kThreadCheckSteps = 300;       // Per run of --threads (each scene runs five times)
+
+static BodyState Capture(const char* name, const std::vector<Particle*>& particles) {
+    BodyState body;
+    body.name = name;
+    for (const Particle* p : particles) {
+        body.positions.push_back(p->position);
+        body.velocities.push_back(p->velocity);
+    }
+    return body;
+}
+
+static BodyState Capture(const char* name, const std::vector<Particle>& particles) {
+    BodyState body;
+    body.name = name;
+    for (const Particle& p : particles) {
+        body.positions.push_back(p.position);
+        body.velocities.push_back(p.velocity);
+    }
+    return body;
+}
+
+static BodyState Capture(const char* name, const GridCloth& grid) {
+    BodyState body;
+    body.name = name;
+    for (size_t i = 0; i < grid.px.size(); i++) {
+        body.positions.push_back(glm::vec3(grid.px[i], grid.py[i], grid.pz[i]));
+        body.velocities.push_back(glm::vec3(grid.vx[i], grid.vy[i], grid.vz[i]));
+    }
+    return body;
+}
+
+// Scene 1 as ParameterSweep sets it up (top row pinned)
+static std::vector<Sample> RunCloth(const Scenario& scenario, bool projectiveDynamics, bool multigrid) {
+    Cloth cloth(20, 20, 0.4f, 2.0f);
+    cloth.projectiveDynamics = projectiveDynamics;
+    cloth.pdSolver.multigrid = multigrid;
+    std::vector<Sample> samples;
+    int every = scenario.steps / scenario.samples;
+    for (int i = 1; i <= scenario.steps; i++) {
+        cloth.UpdatePhysics(scenario.timeStep, kWind);
+        if (i % every == 0) samples.push_back({ i, { Capture("cloth", cloth.particles) }, cloth.diagnostics });
+    }
+    return samples;
+}
+
+static std::vector<Sample> RunCloth(const Scenario& scenario) { return RunCloth(scenario, false, false); }
+static std::vector<Sample> RunProjectiveDynamics(const Scenario& scenario) { return RunCloth(scenario, true, false); }
+static std::vector<Sample> RunMultigrid(const Scenario& scenario) { return RunCloth(scenario, true, true); }
+
+// The same sheet on the structure-of-arrays fast path
+static std::vector<Sample> RunGrid(const Scenario& scenario) {
+    GridCloth grid(20, 20, 0.4f, 2.0f);
+    std::vector<Sample> samples;
+    int every = scenario.steps / scenario.samples;
+    for (int i = 1; i <= scenario.steps; i++) {
+        grid.UpdatePhysics(scenario.timeStep, kWind);
+        if (i % every == 0) samples.push_back({ i, { Capture("grid", grid) } });
+    }
+    return samples;
+}
+
+// Scene 2 from release: canopy, rope chains and the crate's corner attachments
+static std::vector<Sample> RunParachute(const Scenario& scenario, bool jacobiSelfCollision, bool exactRopes) {
+    ParachuteSystem parachute(glm::vec3(0.0f, 20.0f, 0.0f));
+    parachute.jacobiSelfCollision = jacobiSelfCollision;
+    parachute.exactRopes = exactRopes;
+    if (jacobiSelfCollision) {
+        // The spread canopy (0.8 spacing) never comes within the 0.35 self-collision distance,
+        // so start it packed to 40% in x-z: the solver then has contacts from the first step
+        glm::vec3 center(0.0f);
+        for (const Particle* p : parachute.canopy->particles) center += p->position;
+        center /= (float)parachute.canopy->particles.size();
+        for (Particle* p : parachute.canopy->particles) {
+            p->position.x = center.x + (p->position.x - center.x) * 0.4f;
+            p->position.z = center.z + (p->position.z - center.z) * 0.4f;
+        }
+    }
+    parachute.StartFalling();
+    std::vector<Sample> samples;
+    int every = scenario.steps / scenario.samples;
+    for (int i = 1; i <= scenario.steps; i++) {
+        parachute.UpdatePhysics(scenario.timeStep, kWind);
+        if (i % every == 0) {
+            samples.push_back({ i, { Capture("canopy", parachute.canopy->particles),
+                                     Capture("ropes", parachute.ropeParticles),
+                                     Capture("crate", parachute.crate->particles) }, parachute.diagnostics });
+        }
+    }
+    return samples;
+}
+
+static std::vector<Sample> RunParachute(const Scenario& scenario) { return RunParachute(scenario, false, false); }
+static std::vector<Sample> RunJacobi(const Scenario& scenario) { return RunParachute(scenario, true, false); }
+static std::vector<Sample> RunRopes(const Scenario& scenario) { return RunParachute(scenario, false, true); }
+
+// Closed box mesh (outward winding) for the voxelized obstacle
+static void BoxMesh(const glm::vec3& center, const glm::vec3& halfExtents,
+                    std::vector<glm::vec3>& vertices, std::vector<unsigned int>& indices) {
+    vertices.clear();
+    for (int i = 0; i < 8; i++) {
+        glm::vec3 corner((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+        vertices.push_back(center + corner * halfExtents);
+    }
+    indices = { 0, 2, 1, 1, 2, 3,   4, 5, 6, 5, 7, 6,   0, 1, 4, 1, 5, 4,
+                2, 6, 3, 3, 6, 7,   0, 4, 2, 2, 4, 6,   1, 3, 5, 3, 7, 5 };
+}
+
+// A free cloth sheet and a crate dropped on a sphere, a capsule and a voxelized box,
+// so every collider type and the rigid-body contacts are covered
+static std::vector<Sample> RunDrape(const Scenario& scenario) {
+    std::vector<glm::vec3> vertices;
+    std::vector<unsigned int> indices;
+    BoxMesh(glm::vec3(0.0f, -3.0f, 0.0f), glm::vec3(4.0f, 0.5f, 4.0f), vertices, indices);
+    SignedDistanceField table = SignedDistanceField::FromMesh(vertices, indices, 0.25f, 0.5f);
+
+    ColliderSet obstacles = ColliderSet::Ground();
+    obstacles.AddSphere(glm::vec3(-1.5f, 0.0f, 0.0f), 1.2f);
+    obstacles.AddCapsule(glm::vec3(1.5f, -1.0f, -2.0f), glm::vec3(1.5f, -1.0f, 2.0f), 0.6f);
+    obstacles.AddField(&table);
+
+    // Flat in the x-z plane above the obstacles, nothing pinned
+    Cloth cloth(20, 20, 0.4f, 2.0f);
+    cloth.colliders = obstacles;
+    for (int y = 0; y < 20; y++) {
+        for (int x = 0; x < 20; x++) {
+            Particle* p = cloth.particles[y * 20 + x];
+            p->position = glm::vec3((x - 9.5f) * 0.4f, 2.0f, (y - 9.5f) * 0.4f);
+            p->isFixed = false;
+        }
+    }
+    Cube crate(glm::vec3(2.0f, 3.0f, 2.5f), 1.0f, 5.0f);
+
+    std::vector<Sample> samples;
+    int every = scenario.steps / scenario.samples;
+    for (int i = 1; i <= scenario.steps; i++) {
+        cloth.UpdatePhysics(scenario.timeStep, kWind);
+        crate.UpdatePhysics(scenario.timeStep, obstacles);
+        if (i % every == 0) samples.push_back({ i, { Capture("cloth", cloth.particles), Capture("crate", crate.particles) } });
+    }
+    return samples;
+}
+
+// Scene 3 as main.cpp builds it, parachutes released at once and tearing low enough that the
+// flags split, so the shared pools, crates and topology changes are covered. Free-listed
+// slots are compared too.
+static std::vector<Sample> RunWorld(const Scenario& scenario, bool gatherForces) {
+    World world;
+    world.gatherForces = gatherForces;
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 6; col++) {
+            world.AddCloth(glm::vec3(-15.0f + col * 6.0f, 4.0f, -5.0f - row * 6.0f), 10, 10, 0.4f, 1.0f);
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        world.AddParachute(glm::vec3(-20.0f + i * 20.0f, 40.0f, -30.0f));
+    }
+    world.SetTearStretch(1.1f);
+    world.ReleaseParachutes();
+
+    std::vector<Sample> samples;
+    int every = scenario.steps / scenario.samples;
+    for (int i = 1; i <= scenario.steps; i++) {
+        world.UpdatePhysics(scenario.timeStep, kWind);
+        if (i % every == 0) samples.push_back({ i, { Capture("world", world.particles) } });
+    }
+    return samples;
+}
+
+static std::vector<Sample> RunWorld(const Scenario& scenario) { return RunWorld(scenario, false); }
+static std::vector<Sample> RunGather(const Scenario& scenario) { return RunWorld(scenario, true); }
+
+// Text format: a header line, then per sample "sample <step>" and per body
+// "body <name> <count>" followed by one "px py pz vx vy vz" line per particle
+static bool Write(const std::string& path, const Scenario& scenario, const std::vector<Sample>& samples) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) return false;
+    fprintf(file, "golden %s %.9g %d %d\n", scenario.name, scenario.timeStep, scenario.steps, scenario.samples);
+    for (const Sample& sample : samples) {
+        fprintf(file, "sample %d\n", sample.step);
+        for (const BodyState& body : sample.bodies) {
+            fprintf(file, "body %s %zu\n", body.name.c_str(), body.positions.size());
+            for (size_t i = 0; i < body.positions.size(); i++) {
+                const glm::vec3& p = body.positions[i];
+                const glm::vec3& v = body.velocities[i];
+                fprintf(file, "%.9g %.9g %.9g %.9g %.9g %.9g\n", p.x, p.y, p.z, v.x, v.y, v.z);
+            }
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+static bool Read(const std::string& path, Scenario& scenario, std::vector<Sample>& samples) {
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file) return false;
+    char name[64];
+    bool ok = fscanf(file, " golden %63s %f %d %d", name, &scenario.timeStep, &scenario.steps, &scenario.samples) == 4;
+    for (int s = 0; ok && s < scenario.samples; s++) {
+        Sample sample;
+        ok = fscanf(file, " sample %d", &sample.step) == 1;
+        // Bodies until the next sample (or the end of the file)
+        while (ok) {
+            char bodyName[64];
+            size_t count;
+            long mark = ftell(file);
+            if (fscanf(file, " body %63s %zu", bodyName, &count) != 2) {
+                fseek(file, mark, SEEK_SET);
+                break;
+            }
+            BodyState body;
+            body.name = bodyName;
+            body.positions.resize(count);
+            body.velocities.resize(count);
+            for (size_t i = 0; ok && i < count; i++) {
+                glm::vec3& p = body.positions[i];
+                glm::vec3& v = body.velocities[i];
+                ok = fscanf(file, "%f %f %f %f %f %f", &p.x, &p.y, &p.z, &v.x, &v.y, &v.z) == 6;
+            }
+            sample.bodies.push_back(body);
+        }
+        samples.push_back(sample);
+    }
+    fclose(file);
+    return ok;
+}
+
+// Returns false if any body deviates by more than the tolerances (or doesn't match in shape)
+static bool Compare(const std::vector<Sample>& reference, const std::vector<Sample>& current,
+                    float positionTolerance, float velocityTolerance) {
+    if (reference.size() != current.size()) {
+        printf("  sample count differs (%zu vs %zu)\n", reference.size(), current.size());
+        return false;
+    }
+    bool passed = true;
+    printf("  %-8s %-8s %14s %14s\n", "step", "body", "max |dx|", "max |dv|");
+    for (size_t s = 0; s < reference.size(); s++) {
+        const Sample& a = reference[s];
+        const Sample& b = current[s];
+        if (a.step != b.step || a.bodies.size() != b.bodies.size()) {
+            printf("  sample %zu does not match the reference layout\n", s);
+            return false;
+        }
+        for (size_t k = 0; k < a.bodies.size(); k++) {
+            const BodyState& ra = a.bodies[k];
+            const BodyState& rb = b.bodies[k];
+            if (ra.name != rb.name || ra.positions.size() != rb.positions.size()) {
+                printf("  body %s does not match the reference layout\n", ra.name.c_str());
+                return false;
+            }
+            float dx = 0.0f, dv = 0.0f;
+            for (size_t i = 0; i < ra.positions.size(); i++) {
+                // NaN anywhere counts as an infinite deviation
+                float ex = glm::length(ra.positions[i] - rb.positions[i]);
+                float ev = glm::length(ra.velocities[i] - rb.velocities[i]);
+                dx = std::isnan(ex) ? INFINITY : std::max(dx, ex);
+                dv = std::isnan(ev) ? INFINITY : std::max(dv, ev);
+            }
+            bool ok = dx <= positionTolerance && dv <= velocityTolerance;
+            passed &= ok;
+            printf("  %-8d %-8s %14.3e %14.3e%s\n", a.step, ra.name.c_str(), dx, dv, ok ? "" : "  FAIL");
+        }
+    }
+    return passed;
+}
+
+// Bit-for-bit equality of two runs, diagnostics included (their sums are reductions too)
+static bool Identical(const std::vector<Sample>& a, const std::vector<Sample>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t s = 0; s < a.size(); s++) {
+        const SimDiagnostics& da = a[s].diagnostics;
+        const SimDiagnostics& db = b[s].diagnostics;
+        if (da.kineticEnergy != db.kineticEnergy || da.gravitationalEnergy != db.gravitationalEnergy ||
+            da.elasticEnergy != db.elasticEnergy || da.momentum != db.momentum || da.maxStrain != db.maxStrain) {
+            return false;
+        }
+        if (a[s].bodies.size() != b[s].bodies.size()) return false;
+        for (size_t k = 0; k < a[s].bodies.size(); k++) {
+            const BodyState& ra = a[s].bodies[k];
+            const BodyState& rb = b[s].bodies[k];
+            if (ra.positions.size() != rb.positions.size()) return false;
+            if (memcmp(ra.positions.data(), rb.positions.data(), ra.positions.size() * sizeof(glm::vec3)) != 0) return false;
+            if (memcmp(ra.velocities.data(), rb.velocities.data(), ra.velocities.size() * sizeof(glm::vec3)) != 0) return false;
+        }
+    }
+    return true;
+}
+
+// Runs the scene with 1, 4 and 32 threads in deterministic mode and requires identical
+// results, then with 1 and 4 threads in the default mode and reports whether they differ
+static bool CheckThreads(const Scenario& scenario, bool& nondeterministicDiffers) {
+    ParallelSettings& settings = GetParallelSettings();
+    printf("%s (%d steps of %.6g s)\n", scenario.name, scenario.steps, scenario.timeStep);
+
+    settings.deterministic = true;
+    settings.threadCount = 1;
+    std::vector<Sample> reference = scenario.run(scenario);
+    bool passed = true;
+    for (size_t threads : { 4, 32 }) {
+        settings.threadCount = threads;
+        bool ok = Identical(reference, scenario.run(scenario));
+        printf("  deterministic, %2zu threads: %s\n", threads, ok ? "identical to 1 thread" : "DIFFERS from 1 thread  FAIL");
+        passed &= ok;
+    }
+
+    settings.deterministic = false;
+    settings.threadCount = 1;
+    reference = scenario.run(scenario);
+    settings.threadCount = 4;
+    nondeterministicDiffers = !Identical(reference, scenario.run(scenario));
+    printf("  default mode,   4 threads: %s\n", nondeterministicDiffers ? "differs from 1 thread" : "identical to 1 thread");
+    settings.deterministic = true;
+    return passed;
+}
+
+static void PrintUsage() {
+    printf("Usage: GoldenTrajectory (--check dir | --record dir | --threads) [options]\n"
+           "  --check dir            Compare against dir/<scene>.golden (exit code 1 on failure)\n"
+           "  --record dir           Write dir/<scene>.golden from the current build\n"
+           "  --threads              Check that thread counts don't change the results (exit code 1 on failure)\n"
+           "  --scene name|all       Scene to run: cloth, pd, multigrid, grid, parachute, jacobi, ropes,\n"
+           "                         drape, world or gather (default all; for --threads the\n"
+           "                         threaded ones: multigrid, jacobi and gather)\n"
+           "  --tolerance dx,dv      Position and velocity tolerances (default 1e-3,1e-2)\n");
+}
+
+int main(int argc, char** argv) {
+    bool record = false, threads = false;
+    const char* directory = nullptr;
+    const char* scene = "all";
+    float positionTolerance = 1e-3f, velocityTolerance = 1e-2f;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!strcmp(arg, "--help")) { PrintUsage(); return 0; }
+        if (!strcmp(arg, "--threads")) { threads = true; continue; }
+        if (!value) { PrintUsage(); return 1; }
+        i++;
+        if (!strcmp(arg, "--check")) { directory = value; record = false; }
+        else if (!strcmp(arg, "--record")) { directory = value; record = true; }
+        else if (!strcmp(arg, "--scene")) scene = value;
+        else if (!strcmp(arg, "--tolerance")) {
+            if (sscanf(value, "%f,%f", &positionTolerance, &velocityTolerance) != 2) { PrintUsage(); return 1; }
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (!directory && !threads) {
+        PrintUsage();
+        return 1;
+    }
+
+    // References must not depend on the machine's core count
+    GetParallelSettings().deterministic = true;
+
+    const Scenario scenarios[] = {
+        { "cloth", kTimeStep, 3600, 3, RunCloth },                 // 2 s
+        { "pd", kTimeStep, 1800, 3, RunProjectiveDynamics },       // 1 s, Cloth::projectiveDynamics
+        { "multigrid", kTimeStep, 1800, 3, RunMultigrid },         // Same, global step by multigrid PCG
+        { "grid", kTimeStep, 3600, 3, RunGrid },                   // 2 s, GridCloth
+        { "parachute", kTimeStep, 5400, 3, RunParachute },         // 3 s from release
+        { "jacobi", kTimeStep, 5400, 3, RunJacobi },               // Same, packed canopy, jacobiSelfCollision
+        { "ropes", kTimeStep, 5400, 3, RunRopes },                 // Same, exactRopes
+        { "drape", kTimeStep, 3600, 3, RunDrape },                 // 2 s, every collider type
+        { "world", kTimeStep, 1800, 3, RunWorld },                 // 1 s of scene 3
+        { "gather", kTimeStep, 1800, 3, RunGather },               // Same, World::gatherForces
+    };
+
+    if (threads) {
+        // Scenes with parallel loops (and the reductions of multigrid's PCG). Small scenes
+        // would stay below the loops' block sizes, so split everything, reductions included.
+        const char* threadedScenes[] = { "multigrid", "jacobi", "gather" };
+        ParallelSettings& settings = GetParallelSettings();
+        settings.minBlockSizeOverride = 1;
+        settings.deterministicChunkSize = 64;
+        bool passed = true, anyDiffers = false;
+        for (const Scenario& defaults : scenarios) {
+            bool selected = false;
+            for (const char* name : threadedScenes) selected |= !strcmp(name, defaults.name);
+            if (strcmp(scene, "all") == 0 ? !selected : strcmp(scene, defaults.name) != 0) continue;
+            Scenario scenario = defaults;
+            scenario.steps = kThreadCheckSteps;
+            bool differs = false;
+            passed &= CheckThreads(scenario, differs);
+            anyDiffers |= differs;
+        }
+        // Otherwise nothing went through a thread-dependent reduction and the check proved nothing
+        if (!anyDiffers) printf("ERROR::GOLDEN::REDUCTIONS_NOT_THREAD_DEPENDENT\n");
+        printf("%s\n", passed && anyDiffers ? "PASS" : "FAIL");
+        return passed && anyDiffers ? 0 : 1;
+    }
+
+    bool passed = true;
+    for (const Scenario& defaults : scenarios) {
+        if (strcmp(scene, "all") != 0 && strcmp(scene, defaults.name) != 0) continue;
+        std::string path = std::string(directory) + "/" + defaults.name + ".golden";
+
+        if (record) {
+            if (!Write(path, defaults, defaults.run(defaults))) {
+                printf("ERROR::GOLDEN::CANNOT_WRITE %s\n", path.c_str());
+                return 1;
+            }
+            printf("Recorded %s\n", path.c_str());
+            continue;
+        }
+
+        // The file's step settings win, so old references stay comparable
+        Scenario scenario = defaults;
+        std::vector<Sample> reference;
+        if (!Read(path, scenario, reference)) {
+            printf("ERROR::GOLDEN::CANNOT_READ %s\n", path.c_str());
+            return 1;
+        }
+        scenario.name = defaults.name;
+        printf("%s (%d steps of %.6g s)\n", scenario.name, scenario.steps, scenario.timeStep);
+        bool ok = Compare(reference, scenario.run(scenario), positionTolerance, velocityTolerance);
+        printf("  %s\n", ok ? "PASS" : "FAIL");
+        passed &= ok;
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+// ParameterSweep.cpp (Headless batch runner for tuning the cloth and parachute scenes)
+//
+// Runs the cartesian product of the given parameter lists, one independent simulation per
+// worker thread, and writes one CSV row per run. No OpenGL context is created: the scenes
+// only touch GL when they are drawn.
+//
+// Example:
+//   ParameterSweep --scene parachute --ksStruct 900,1350,1800 --drag 2,3,4 --out sweep.csv
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Cloth.h"
+#include "ParachuteSystem.h"
+
+struct SweepRun {
+    bool parachute;
+    float ksStruct, ksShear, ksBend;
+    float dragCoefficient;
+    float kRepel;
+};
+
+struct SweepResult {
+    float settlingTime;      // Last time any free particle moved faster than settleSpeed (-1 = never settled)
+    float maxStretch;        // Largest length / rest length of any cloth spring
+    float crateLandingSpeed; // Crate speed on first ground contact (-1 = no crate or never landed)
+    double wallTime;         // Seconds spent simulating this run
+};
+
+struct SweepSettings {
+    float duration = 20.0f;          // Simulated seconds per run
+    float timeStep = 1.0f / 1800.0f; // 30 substeps of a 60 Hz frame, like the interactive loop
+    float settleSpeed = 0.05f;
+    glm::vec3 wind = glm::vec3(0.0f);
+};
+
+static std::vector<float> ParseList(const char* text) {
+    std::vector<float> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back((float)atof(item.c_str()));
+    }
+    return values;
+}
+
+// Scans the cloth springs and free particles of one step for the metrics
+static void Measure(const Cloth& cloth, const std::vector<Particle*>& particles,
+                    float time, const SweepSettings& settings, SweepResult& result) {
+    result.maxStretch = std::max(result.maxStretch, cloth.MaxStretch());
+    for (const Particle* p : particles) {
+        if (p->isFixed) continue;
+        if (glm::dot(p->velocity, p->velocity) > settings.settleSpeed * settings.settleSpeed) {
+            result.settlingTime = time;
+            return;
+        }
+    }
+}
+
+static SweepResult RunCloth(const SweepRun& run, const SweepSettings& settings) {
+    SweepResult result = { 0.0f, 0.0f, -1.0f, 0.0 };
+
+    // Same setup as scene 1 (top row pinned)
+    Cloth cloth(20, 20, 0.4f, 2.0f);
+    cloth.SetSpringConstants(run.ksStruct, run.ksShear, run.ksBend);
+    cloth.dragCoefficient = run.dragCoefficient;
+    cloth.kRepel = run.kRepel;
+
+    int steps = (int)(settings.duration / settings.timeStep);
+    for (int i = 0; i < steps; i++) {
+        cloth.UpdatePhysics(settings.timeStep, settings.wind);
+        Measure(cloth, cloth.particles, (i + 1) * settings.timeStep, settings, result);
+    }
+    if (result.settlingTime >= settings.duration - settings.timeStep) result.settlingTime = -1.0f;
+    return result;
+}
+
+static SweepResult RunParachute(const SweepRun& run, const SweepSettings& settings) {
+    SweepResult result = { 0.0f, 0.0f, -1.0f, 0.0 };
+    float groundY = -10.0f;
+
+    // Same setup as scene 2; the canopy springs take the swept values directly
+    ParachuteSystem parachute(glm::vec3(0.0f, 40.0f, 0.0f));
+    parachute.canopy->SetSpringConstants(run.ksStruct, run.ksShear, run.ksBend);
+    parachute.dragCoefficient = run.dragCoefficient;
+    parachute.StartFalling();
+
+    std::vector<Particle*> freeParticles = parachute.canopy->particles;
+    freeParticles.insert(freeParticles.end(), parachute.ropeParticles.begin(), parachute.ropeParticles.end());
+
+    int steps = (int)(settings.duration / settings.timeStep);
+    for (int i = 0; i < steps; i++) {
+        glm::vec3 crateVelocity = parachute.crate->body.velocity;
+        parachute.UpdatePhysics(settings.timeStep, settings.wind);
+        Measure(*parachute.canopy, freeParticles, (i + 1) * settings.timeStep, settings, result);
+
+        // Landing: the speed before the step in which a corner first reached the ground
+        if (result.crateLandingSpeed < 0.0f) {
+            for (size_t c = 0; c < parachute.crate->body.localPoints.size(); c++) {
+                if (parachute.crate->body.GetPointPosition(c).y <= groundY + 0.01f) {
+                    result.crateLandingSpeed = glm::length(crateVelocity);
+                    break;
+                }
+            }
+        }
+        if (glm::length(parachute.crate->body.velocity) > settings.settleSpeed) {
+            result.settlingTime = (i + 1) * settings.timeStep;
+        }
+    }
+    if (result.settlingTime >= settings.duration - settings.timeStep) result.settlingTime = -1.0f;
+    return result;
+}
+
+static void PrintUsage() {
+    printf("Usage: ParameterSweep [options]\n"
+           "  --scene cloth|parachute   Scene to simulate (default cloth)\n"
+           "  --ksStruct a,b,...        Structural spring constants\n"
+           "  --ksShear a,b,...         Shear spring constants\n"
+           "  --ksBend a,b,...          Bending spring constants\n"
+           "  --drag a,b,...            Drag coefficients\n"
+           "  --kRepel a,b,...          Self-collision stiffness (cloth scene)\n"
+           "  --duration seconds        Simulated time per run (default 20)\n"
+           "  --dt seconds              Physics step (default 1/1800)\n"
+           "  --wind x,y,z              Uniform wind (default 0)\n"
+           "  --threads n               Worker count (default: all cores)\n"
+           "  --out file.csv            Output file (default sweep.csv)\n");
+}
+
+int main(int argc, char** argv) {
+    // 1. Parameter grid (lists left empty get the values the scene ships with)
+    bool parachute = false;
+    std::vector<float> ksStruct, ksShear, ksBend, drag, kRepel;
+    SweepSettings settings;
+    unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    const char* outPath = "sweep.csv";
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!strcmp(arg, "--help")) { PrintUsage(); return 0; }
+        if (!value) { PrintUsage(); return 1; }
+        i++;
+        if (!strcmp(arg, "--scene")) parachute = !strcmp(value, "parachute");
+        else if (!strcmp(arg, "--ksStruct")) ksStruct = ParseList(value);
+        else if (!strcmp(arg, "--ksShear"))  ksShear = ParseList(value);
+        else if (!strcmp(arg, "--ksBend"))   ksBend = ParseList(value);
+        else if (!strcmp(arg, "--drag"))     drag = ParseList(value);
+        else if (!strcmp(arg, "--kRepel"))   kRepel = ParseList(value);
+        else if (!strcmp(arg, "--duration")) settings.duration = (float)atof(value);
+        else if (!strcmp(arg, "--dt"))       settings.timeStep = (float)atof(value);
+        else if (!strcmp(arg, "--threads"))  threadCount = std::max(1, atoi(value));
+        else if (!strcmp(arg, "--out"))      outPath = value;
+        else if (!strcmp(arg, "--wind")) {
+            std::vector<float> w = ParseList(value);
+            if (w.size() == 3) settings.wind = glm::vec3(w[0], w[1], w[2]);
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    // The canopy is 3x stiffer than the scene 1 cloth, has more drag and
+    // uses position-based self-collision (kRepel is unused)
+    float stiffness = parachute ? 3.0f : 1.0f;
+    if (ksStruct.empty()) ksStruct = { 450.0f * stiffness };
+    if (ksShear.empty())  ksShear = { 100.0f * stiffness };
+    if (ksBend.empty())   ksBend = { 200.0f * stiffness };
+    if (drag.empty())     drag = { parachute ? 3.0f : 1.5f };
+    if (kRepel.empty() || parachute) kRepel = { parachute ? 0.0f : 2000.0f };
+
+    std::vector<SweepRun> runs;
+    for (float a : ksStruct)
+        for (float b : ksShear)
+            for (float c : ksBend)
+                for (float d : drag)
+                    for (float e : kRepel)
+                        runs.push_back({ parachute, a, b, c, d, e });
+    if (runs.empty()) {
+        printf("ERROR::SWEEP::EMPTY_GRID\n");
+        return 1;
+    }
+
+    FILE* out = fopen(outPath, "w");
+    if (!out) {
+        printf("ERROR::SWEEP::CANNOT_OPEN %s\n", outPath);
+        return 1;
+    }
+    fprintf(out, "scene,ksStruct,ksShear,ksBend,dragCoefficient,kRepel,settlingTime,maxStretch,crateLandingSpeed,wallTime\n");
+
+    // 2. Workers pull runs from a shared counter; every run owns its whole scene
+    std::atomic<size_t> next(0);
+    std::mutex outputMutex;
+    size_t finished = 0;
+    auto worker = [&]() {
+        for (size_t r = next++; r < runs.size(); r = next++) {
+            const SweepRun& run = runs[r];
+            auto start = std::chrono::steady_clock::now();
+            SweepResult result = run.parachute ? RunParachute(run, settings) : RunCloth(run, settings);
+            result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            fprintf(out, "%s,%g,%g,%g,%g,%g,%g,%g,%g,%.3f\n", run.parachute ? "parachute" : "cloth",
+                    run.ksStruct, run.ksShear, run.ksBend, run.dragCoefficient, run.kRepel,
+                    result.settlingTime, result.maxStretch, result.crateLandingSpeed, result.wallTime);
+            fflush(out);
+            printf("[%zu/%zu] run %zu done in %.1fs\n", ++finished, runs.size(), r, result.wallTime);
+        }
+    };
+
+    threadCount = (unsigned int)std::min<size_t>(threadCount, runs.size());
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threadCount; t++) workers.emplace_back(worker);
+    worker(); // The main thread works too
+    for (std::thread& w : workers) w.join();
+
+    fclose(out);
+    printf("Wrote %zu runs to %s\n", runs.size(), outPath);
+    return 0;
+}
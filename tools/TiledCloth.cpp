@@ -0,0 +1,162 @@
+// TiledCloth.cpp (Multi-process simulation of one large cloth sheet, Linux only)
+//
+// The grid is split into tilesX x tilesY ClothTiles, each run by its own process. All processes
+// share the double-buffered positions/velocities through an anonymous shared mapping created
+// before fork(), so the halo "exchange" is reading the neighbouring rows and columns of the
+// read buffer. A process-shared barrier separates the steps.
+//
+// Example (4 processes, 1M particles, compare against a single process):
+//   TiledCloth --width 1000 --height 1000 --tiles 2x2 --steps 200 --verify
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ClothTile.h"
+
+struct SharedHeader {
+    pthread_barrier_t barrier;
+};
+
+// One mapping: header, then positions[2] and velocities[2]
+static void* MapShared(size_t bytes) {
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+static ClothGridState MakeState(void* memory, int width, int height) {
+    ClothGridState state;
+    state.width = width;
+    state.height = height;
+    size_t count = (size_t)width * height;
+    glm::vec3* arrays = reinterpret_cast<glm::vec3*>(static_cast<char*>(memory) + sizeof(SharedHeader));
+    state.positions[0] = arrays;
+    state.positions[1] = arrays + count;
+    state.velocities[0] = arrays + 2 * count;
+    state.velocities[1] = arrays + 3 * count;
+    return state;
+}
+
+static ClothTile MakeTile(int index, int tilesX, int tilesY, int width, int height, float spacing, float particleMass) {
+    int tx = index % tilesX, ty = index / tilesX;
+    return ClothTile(width * tx / tilesX, height * ty / tilesY,
+                     width * (tx + 1) / tilesX, height * (ty + 1) / tilesY, spacing, particleMass);
+}
+
+// Runs every tile in its own process (the caller takes tile 0); returns the buffer holding the result
+static int RunTiled(const ClothGridState& state, SharedHeader* header, int tilesX, int tilesY,
+                    int steps, float deltaTime, float spacing, float particleMass) {
+    int tileCount = tilesX * tilesY;
+    std::vector<pid_t> children;
+    for (int t = 1; t < tileCount; t++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            ClothTile tile = MakeTile(t, tilesX, tilesY, state.width, state.height, spacing, particleMass);
+            int read = 0;
+            for (int s = 0; s < steps; s++) {
+                tile.Step(state, read, deltaTime, glm::vec3(0.0f));
+                pthread_barrier_wait(&header->barrier);
+                read = 1 - read;
+            }
+            _exit(0);
+        }
+        if (pid < 0) {
+            perror("fork");
+            exit(1);
+        }
+        children.push_back(pid);
+    }
+
+    ClothTile tile = MakeTile(0, tilesX, tilesY, state.width, state.height, spacing, particleMass);
+    int read = 0;
+    for (int s = 0; s < steps; s++) {
+        tile.Step(state, read, deltaTime, glm::vec3(0.0f));
+        pthread_barrier_wait(&header->barrier);
+        read = 1 - read;
+    }
+    for (pid_t pid : children) waitpid(pid, nullptr, 0);
+    return read;
+}
+
+int main(int argc, char** argv) {
+    int width = 200, height = 200, tilesX = 2, tilesY = 2, steps = 500;
+    float spacing = 0.4f, totalMass = 2.0f, deltaTime = 1.0f / 1800.0f;
+    bool verify = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : "";
+        if (!strcmp(argv[i], "--width")) { width = atoi(value); i++; }
+        else if (!strcmp(argv[i], "--height")) { height = atoi(value); i++; }
+        else if (!strcmp(argv[i], "--tiles")) { sscanf(value, "%dx%d", &tilesX, &tilesY); i++; }
+        else if (!strcmp(argv[i], "--steps")) { steps = atoi(value); i++; }
+        else if (!strcmp(argv[i], "--dt")) { deltaTime = (float)atof(value); i++; }
+        else if (!strcmp(argv[i], "--verify")) verify = true;
+        else {
+            printf("Usage: TiledCloth [--width n] [--height n] [--tiles XxY] [--steps n] [--dt s] [--verify]\n");
+            return 1;
+        }
+    }
+    // Every tile must be at least as wide as the halo
+    if (width < 2 || height < 2 || tilesX < 1 || tilesY < 1 ||
+        width / tilesX < ClothTile::kHalo || height / tilesY < ClothTile::kHalo) {
+        printf("ERROR::TILEDCLOTH::BAD_LAYOUT\n");
+        return 1;
+    }
+    // Same per-particle mass as a 20x20 Cloth of totalMass, so bigger sheets behave alike
+    float particleMass = totalMass / (20 * 20);
+
+    // 1. Shared state, created before fork so every process sees the same mapping
+    size_t bytes = sizeof(SharedHeader) + 4 * sizeof(glm::vec3) * (size_t)width * height;
+    void* memory = MapShared(bytes);
+    if (!memory) {
+        perror("mmap");
+        return 1;
+    }
+    SharedHeader* header = static_cast<SharedHeader*>(memory);
+    pthread_barrierattr_t attributes;
+    pthread_barrierattr_init(&attributes);
+    pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&header->barrier, &attributes, tilesX * tilesY);
+
+    ClothGridState state = MakeState(memory, width, height);
+    ClothTile::InitGrid(state, spacing);
+
+    // 2. Tiled run
+    auto start = std::chrono::steady_clock::now();
+    int result = RunTiled(state, header, tilesX, tilesY, steps, deltaTime, spacing, particleMass);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%dx%d particles, %dx%d tiles, %d steps: %.3fs (%.1f M particle-steps/s)\n",
+           width, height, tilesX, tilesY, steps, seconds, (double)width * height * steps / seconds * 1e-6);
+
+    // 3. Optional check against one process holding the whole sheet
+    int status = 0;
+    if (verify) {
+        void* referenceMemory = MapShared(bytes);
+        SharedHeader* referenceHeader = static_cast<SharedHeader*>(referenceMemory);
+        pthread_barrier_init(&referenceHeader->barrier, &attributes, 1);
+        ClothGridState reference = MakeState(referenceMemory, width, height);
+        ClothTile::InitGrid(reference, spacing);
+        int referenceResult = RunTiled(reference, referenceHeader, 1, 1, steps, deltaTime, spacing, particleMass);
+
+        float maxError = 0.0f;
+        for (size_t i = 0; i < (size_t)width * height; i++) {
+            maxError = glm::max(maxError, glm::length(state.positions[result][i] - reference.positions[referenceResult][i]));
+        }
+        printf("Max position difference to a single tile: %g\n", maxError);
+        status = maxError == 0.0f ? 0 : 1;
+
+        pthread_barrier_destroy(&referenceHeader->barrier);
+        munmap(referenceMemory, bytes);
+    }
+
+    pthread_barrier_destroy(&header->barrier);
+    pthread_barrierattr_destroy(&attributes);
+    munmap(memory, bytes);
+    return status;
+}